@@ -0,0 +1,403 @@
+/*	Non-interactive benchmark driver, built as 'maze_bench' (see Makefile).
+	Generates (or loads) one maze, runs a search on it N times and prints one record per run:
+
+	./maze_bench --size 2000 --p 0.7 --seed 42 --start 0,0 --goal 1999,1999 [--goal x,y ...]
+	             [--algorithm ucs|astar|jps|bidirectional|hpa|wavefront|oracle|cpd|alt|wastar|ara] [--frontier 0|1|2] [--repeat N]
+	             [--threads N] [--landmarks K] [--weight W] [--deadline-ms MS] [--step N] [--format csv|json] [--load FILE]
+*/
+#define MAZE_NO_MAIN
+#include "maze.c"
+
+#include <sys/resource.h>
+
+enum { BENCH_UCS, BENCH_A_STAR, BENCH_JPS, BENCH_BIDIRECTIONAL, BENCH_HPA, BENCH_WAVEFRONT, BENCH_ORACLE, BENCH_CPD, BENCH_ALT, BENCH_WEIGHTED_A_STAR, BENCH_ARA, BENCH_ALGORITHMS };
+
+const char *algorithm_names[] = {"ucs", "astar", "jps", "bidirectional", "hpa", "wavefront", "oracle", "cpd", "alt", "wastar", "ara"};
+
+void usage(char *program) {
+
+	printf("Usage: %s --size N --p P --seed SEED --start X,Y --goal X,Y [--goal X,Y ...]\n", program);
+	printf("       [--algorithm ucs|astar|jps|bidirectional|hpa|wavefront|oracle|cpd|alt|wastar|ara] [--frontier 0|1|2] [--repeat N] [--threads N]\n");
+	printf("       [--landmarks K] [--weight W] [--deadline-ms MS] [--step N] [--format csv|json] [--load FILE] [--components 0|1]\n");
+	exit(1);
+}
+
+void parse_cell(char *text, coordinates_t *cell, char *program) {
+
+	if (sscanf(text, "%d,%d", &(cell -> x), &(cell -> y)) != 2) {
+
+		usage(program);
+	}
+}
+
+long elapsed_ns(struct timespec *start, struct timespec *end) {
+
+	return (end -> tv_sec - start -> tv_sec) * 1000000000L + (end -> tv_nsec - start -> tv_nsec);
+}
+
+long peak_rss_kb() {	// Largest resident set of the process so far.
+
+	struct rusage usage;
+
+	getrusage(RUSAGE_SELF, &usage);
+	return usage.ru_maxrss;
+}
+
+void run_search(int algorithm, workspace_t *workspace, hpa_t *hpa, oracle_t *oracle, cpd_t *cpd, maze_t *maze, coordinates_t S, goals_t *goals, int frontier_type, int thread_count, double weight, long deadline_ms, int step_expansions, long *max_step_ns, search_result_t *result) {
+
+	coordinates_t meeting_cell;
+	coordinates_t *path = NULL;
+	search_t search;
+	long step_ns;
+	int done = 0;
+
+	// Every algorithm ends with the route in memory, so all of them pay for rebuilding it.
+	switch (algorithm) {
+
+		case BENCH_UCS:
+		case BENCH_A_STAR:
+		case BENCH_ALT:		// The landmarks are already attached to 'goals'.
+			if (step_expansions > 0) {
+
+				// Sliced like a frame loop would, timing the longest slice.
+				search_begin(&search, workspace, maze, S, goals, (algorithm != BENCH_UCS) ? 1.0 : 0.0);
+				while (!done) {
+
+					step_ns = now_ns();
+					done = search_step(&search, step_expansions);
+					step_ns = now_ns() - step_ns;
+					*max_step_ns = (step_ns > *max_step_ns) ? step_ns : *max_step_ns;
+				}
+
+				*result = *search_result(&search);
+			}
+			else {
+
+				best_first(workspace, maze, S, goals, algorithm != BENCH_UCS, result);
+			}
+
+			if (result -> goal != 0) {
+
+				path = reconstruct_path(workspace -> parent, maze -> size, S, result -> goal_cell, result -> path_cost);
+			}
+			break;
+
+		case BENCH_WEIGHTED_A_STAR:
+			weighted_best_first(workspace, maze, S, goals, weight, result);
+			if (result -> goal != 0) {
+
+				path = reconstruct_path(workspace -> parent, maze -> size, S, result -> goal_cell, result -> path_cost);
+			}
+			break;
+
+		case BENCH_ARA:
+			path = ara_star_search(maze, S, goals, weight, now_ns() + deadline_ms * 1000000, result, NULL);
+			break;
+
+		case BENCH_JPS:
+			path = jps_search(maze, S, goals, frontier_type, result);
+			break;
+
+		case BENCH_BIDIRECTIONAL:
+			path = bidirectional_search(maze, S, goals, frontier_type, result, &meeting_cell);
+			break;
+
+		case BENCH_HPA:
+			path = hpa_search(hpa, S, goals, result);
+			break;
+
+		case BENCH_WAVEFRONT:
+			path = wavefront_search(maze, S, goals, thread_count, result);
+			break;
+
+		case BENCH_ORACLE:
+			path = oracle_search(oracle, S, result);
+			break;
+
+		default:
+			path = cpd_search(cpd, S, goals, result);
+			break;
+	}
+
+	free(path);
+}
+
+int main(int argc, char *argv[]) {
+
+	maze_t *maze = NULL;
+	workspace_t *workspace = NULL;
+	hpa_t *hpa = NULL;
+	oracle_t *oracle = NULL;
+	cpd_t *cpd = NULL;
+	landmarks_t *landmarks = NULL;
+	goals_t *goals = NULL;
+	search_result_t result;
+	coordinates_t S = {0, 0}, loaded_S;
+	coordinates_t *goal_cells = NULL, *new_goal_cells = NULL;
+	coordinates_t *loaded_goal_cells = NULL;
+	struct timespec start, end;
+	char *load_file = NULL;
+	int maze_size = 0, goal_count = 0, goal_capacity = 0, algorithm = BENCH_A_STAR, frontier_type = FRONTIER_BINARY_HEAP, used_frontier;
+	int repeat = 1, thread_count = 1, landmark_count = ALT_LANDMARKS, step_expansions = 0, json = 0, start_given = 0, components = 0, i;
+	double p = 0.7, weight = ARA_INITIAL_WEIGHT, seconds;
+	uint64_t seed = 1;
+	long generation_ns = 0, preprocess_ns = 0, search_ns, max_step_ns, deadline_ms = ARA_BUDGET_MS;
+
+	for (i = 1; i < argc; i++) {
+
+		if (i + 1 >= argc) {
+
+			usage(argv[0]);
+		}
+
+		if (strcmp(argv[i], "--size") == 0) {
+
+			maze_size = atoi(argv[++i]);
+		}
+		else if (strcmp(argv[i], "--p") == 0) {
+
+			p = atof(argv[++i]);
+		}
+		else if (strcmp(argv[i], "--seed") == 0) {
+
+			seed = strtoull(argv[++i], NULL, 10);
+		}
+		else if (strcmp(argv[i], "--start") == 0) {
+
+			parse_cell(argv[++i], &S, argv[0]);
+			start_given = 1;
+		}
+		else if (strcmp(argv[i], "--goal") == 0) {
+
+			if (goal_count == goal_capacity) {
+
+				goal_capacity = (goal_capacity == 0) ? 8 : 2 * goal_capacity;
+				new_goal_cells = (coordinates_t *)realloc(goal_cells, goal_capacity * sizeof(coordinates_t));
+				if (new_goal_cells == NULL) {
+
+					printf("Trouble allocating memory for exit cells.\n");
+					exit(1);
+				}
+				goal_cells = new_goal_cells;
+			}
+
+			parse_cell(argv[++i], &(goal_cells[goal_count++]), argv[0]);
+		}
+		else if (strcmp(argv[i], "--algorithm") == 0) {
+
+			i++;
+			for (algorithm = 0; algorithm < BENCH_ALGORITHMS && strcmp(argv[i], algorithm_names[algorithm]) != 0; algorithm++);
+			if (algorithm == BENCH_ALGORITHMS) {
+
+				usage(argv[0]);
+			}
+		}
+		else if (strcmp(argv[i], "--frontier") == 0) {
+
+			frontier_type = atoi(argv[++i]);
+		}
+		else if (strcmp(argv[i], "--repeat") == 0) {
+
+			repeat = atoi(argv[++i]);
+		}
+		else if (strcmp(argv[i], "--threads") == 0) {
+
+			thread_count = atoi(argv[++i]);
+		}
+		else if (strcmp(argv[i], "--landmarks") == 0) {
+
+			landmark_count = atoi(argv[++i]);
+		}
+		else if (strcmp(argv[i], "--weight") == 0) {
+
+			weight = atof(argv[++i]);
+		}
+		else if (strcmp(argv[i], "--deadline-ms") == 0) {
+
+			deadline_ms = atol(argv[++i]);
+		}
+		else if (strcmp(argv[i], "--step") == 0) {
+
+			step_expansions = atoi(argv[++i]);
+		}
+		else if (strcmp(argv[i], "--format") == 0) {
+
+			json = strcmp(argv[++i], "json") == 0;
+		}
+		else if (strcmp(argv[i], "--load") == 0) {
+
+			load_file = argv[++i];
+		}
+		else if (strcmp(argv[i], "--components") == 0) {
+
+			components = atoi(argv[++i]);
+		}
+		else {
+
+			usage(argv[0]);
+		}
+	}
+
+	if (frontier_type < FRONTIER_BINARY_HEAP || frontier_type > FRONTIER_BUCKET_QUEUE || repeat < 1 || thread_count < 1 || landmark_count < 1 || weight < 1 || deadline_ms < 1 || step_expansions < 0 || p < 0 || p > 1) {
+
+		usage(argv[0]);
+	}
+
+	clock_gettime(CLOCK_MONOTONIC, &start);
+
+	if (load_file != NULL) {
+
+		// The file's own start and exit cells, unless given on the command line.
+		maze = load_maze(load_file, &loaded_S, &loaded_goal_cells, &i);
+		maze_size = maze -> size;
+		if (!start_given) {
+
+			S = loaded_S;
+		}
+
+		if (goal_count == 0) {
+
+			goal_cells = loaded_goal_cells;
+			goal_count = i;
+		}
+		else {
+
+			free(loaded_goal_cells);
+		}
+	}
+
+	if (maze_size < 1 || goal_count == 0 || !in_maze(S, maze_size)) {
+
+		usage(argv[0]);
+	}
+
+	for (i = 0; i < goal_count; i++) {
+
+		if (!in_maze(goal_cells[i], maze_size)) {
+
+			usage(argv[0]);
+		}
+	}
+
+	goals = new_goals(goal_cells, goal_count, maze_size);
+
+	if (load_file == NULL) {
+
+		maze = create_maze(maze_size);
+		set_maze_layout(maze, p, seed, (int)sysconf(_SC_NPROCESSORS_ONLN), S, goals);
+	}
+
+	clock_gettime(CLOCK_MONOTONIC, &end);
+	generation_ns = elapsed_ns(&start, &end);
+
+	workspace = new_workspace(frontier_type, maze_size);
+
+	// Component labels, the abstract graph for HPA*, the goal oracle, the path database and the landmarks are built once and shared by every run, like a long lived server would.
+	clock_gettime(CLOCK_MONOTONIC, &start);
+	if (components) {
+
+		label_components(maze);
+	}
+	if (algorithm == BENCH_HPA) {
+
+		hpa = new_hpa(maze, HPA_CLUSTER_SIZE);
+	}
+	if (algorithm == BENCH_ORACLE) {
+
+		oracle = new_oracle(maze, goals);
+	}
+	if (algorithm == BENCH_CPD) {
+
+		cpd = new_cpd(maze, thread_count);
+	}
+	if (algorithm == BENCH_ALT) {
+
+		landmarks = new_landmarks(maze, landmark_count);
+		use_landmarks(goals, landmarks);
+	}
+	clock_gettime(CLOCK_MONOTONIC, &end);
+	preprocess_ns = elapsed_ns(&start, &end);
+
+	if (json) {
+
+		printf("[\n");
+	}
+	else {
+
+		printf("algorithm,frontier,threads,size,p,seed,run,generation_ms,preprocess_ms,search_ms,max_step_ms,expansions,expansions_per_sec,path_cost,pushes,pops,stale_pops,max_frontier,closed,search_bytes,peak_rss_kb\n");
+	}
+
+	// Reported is the frontier the searches run on: ARA* always keeps a heap, and weighted A* leaves a bucket queue for one.
+	used_frontier = frontier_type;
+	if (algorithm == BENCH_ARA) {
+
+		used_frontier = FRONTIER_BINARY_HEAP;
+	}
+	else if (algorithm == BENCH_WEIGHTED_A_STAR) {
+
+		used_frontier = search_frontier_type(frontier_type, weight);
+	}
+
+	for (i = 0; i < repeat; i++) {
+
+		max_step_ns = 0;
+		clock_gettime(CLOCK_MONOTONIC, &start);
+		run_search(algorithm, workspace, hpa, oracle, cpd, maze, S, goals, frontier_type, thread_count, weight, deadline_ms, step_expansions, &max_step_ns, &result);
+		clock_gettime(CLOCK_MONOTONIC, &end);
+
+		search_ns = elapsed_ns(&start, &end);
+		max_step_ns = (max_step_ns > 0) ? max_step_ns : search_ns;		// Unsliced, the whole search is one step.
+		seconds = search_ns / 1e9;
+
+		if (json) {
+
+			printf("  {\"algorithm\": \"%s\", \"frontier\": %d, \"threads\": %d, \"size\": %d, \"p\": %g, \"seed\": %" PRIu64 ", \"run\": %d, "
+				"\"generation_ms\": %.3f, \"preprocess_ms\": %.3f, \"search_ms\": %.3f, \"max_step_ms\": %.3f, \"expansions\": %d, \"expansions_per_sec\": %.0f, "
+				"\"path_cost\": %d, \"pushes\": %ld, \"pops\": %ld, \"stale_pops\": %ld, \"max_frontier\": %d, \"closed\": %ld, "
+				"\"search_bytes\": %zu, \"peak_rss_kb\": %ld}%s\n",
+				algorithm_names[algorithm], used_frontier, thread_count, maze_size, p, seed, i,
+				generation_ns / 1e6, preprocess_ns / 1e6, search_ns / 1e6, max_step_ns / 1e6, result.expansion_count, (seconds > 0) ? result.expansion_count / seconds : 0,
+				result.path_cost, result.stats.pushes, result.stats.pops, result.stats.stale_pops, result.stats.max_frontier, result.stats.closed_count,
+				result.stats.bytes_allocated, peak_rss_kb(), (i + 1 < repeat) ? "," : "");
+		}
+		else {
+
+			printf("%s,%d,%d,%d,%g,%" PRIu64 ",%d,%.3f,%.3f,%.3f,%.3f,%d,%.0f,%d,%ld,%ld,%ld,%d,%ld,%zu,%ld\n",
+				algorithm_names[algorithm], used_frontier, thread_count, maze_size, p, seed, i,
+				generation_ns / 1e6, preprocess_ns / 1e6, search_ns / 1e6, max_step_ns / 1e6, result.expansion_count, (seconds > 0) ? result.expansion_count / seconds : 0,
+				result.path_cost, result.stats.pushes, result.stats.pops, result.stats.stale_pops, result.stats.max_frontier, result.stats.closed_count,
+				result.stats.bytes_allocated, peak_rss_kb());
+		}
+	}
+
+	if (json) {
+
+		printf("]\n");
+	}
+
+	if (hpa != NULL) {
+
+		free_hpa(hpa);
+	}
+
+	if (oracle != NULL) {
+
+		free_oracle(oracle);
+	}
+
+	if (cpd != NULL) {
+
+		free_cpd(cpd);
+	}
+
+	if (landmarks != NULL) {
+
+		free_landmarks(landmarks);
+	}
+
+	free_workspace(workspace);
+	free_goals(goals);
+	free(goal_cells);
+	free_maze(maze);
+	return 0;
+}
@@ -1,1348 +1,7213 @@
 #include <stdio.h>
 #include <stdlib.h>
+#include <stdint.h>
+#include <inttypes.h>
+#include <string.h>
 #include <unistd.h>
 #include <time.h>
 #include <math.h>
+#include <pthread.h>
+#include <fcntl.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
 
 typedef struct coordinates_s{
 
 	int x, y;
 }coordinates_t;
 
+typedef struct maze_s {
+
+	int size;				// The maze has size * size cells.
+	int stride;				// 64 bit words per row, every row starts on a word boundary.
+	uint64_t *cells;		// Row major, one bit per cell (1 free, 0 obstacle), 64 byte aligned.
+	void *mapping;			// Maze file 'cells' points into, NULL if 'cells' was allocated.
+	size_t mapping_length;
+	uint32_t *component;	// Connected component of every cell, see label_components(). NULL until labeled.
+	uint32_t component_count;
+}maze_t;
+
+#define LANDMARK_UNKNOWN UINT16_MAX
+
+typedef struct landmarks_s {	// Distances from a few landmark cells to every cell, see new_landmarks().
+
+	int count;
+	coordinates_t *cells;
+	uint16_t *distance;		// distance[cell * count + i] is the distance from landmark i, capped at LANDMARK_UNKNOWN - 1, LANDMARK_UNKNOWN if out of reach.
+}landmarks_t;
+
+typedef struct goals_s {
+
+	coordinates_t *cells;	// Exit cells, cells[0] is G1.
+	int count;
+	int maze_size;
+	uint64_t *bitmap;		// One bit per maze cell, set on exits, for an O(1) goal test. NULL when there are few exits.
+	int *nearest;			// Chebyshev distance from every cell to the closest exit, NULL when there are few exits.
+	landmarks_t *landmarks;	// Tighten the heuristic with these, see use_landmarks(). NULL for plain octile distance.
+	int *landmark_min;		// Closest and farthest exit from each landmark,
+	int *landmark_max;		// -1 if the landmark can't tell the distance to every exit.
+}goals_t;
+
+#define CELL_INDEX(cell, maze_size) ((size_t)(cell).x * (maze_size) + (cell).y)	// Row major index of a cell.
+
 typedef struct node_s {
 
 	int priority;			// g(n) in UCS, f(n) in A*. Higher priority comes with lower values.
 	coordinates_t cell;		// Nodes place in the maze.
-	struct node_s *next;
+	struct node_s *next;	// Next node of the same bucket (bucket queue only).
+	struct node_s *prev;	// Previous node of the same bucket (bucket queue only).
 }node_t;
 
+typedef struct node_pool_s {
+
+	node_t **slabs;			// Blocks of NODE_SLAB_SIZE nodes, all released together by free_pool().
+	int slab_count;
+	int slab_capacity;		// Allocated length of 'slabs'.
+	int slab_used;			// Nodes already handed out from the newest slab.
+	node_t *free_list;		// Released nodes waiting to be reused, linked through 'next'.
+	long node_reuses;		// Released nodes handed out again from 'free_list'.
+}node_pool_t;
+
+typedef struct frontier_s {
+
+	int type;				// One of the FRONTIER_* backends below.
+	int count;				// Nodes currently in the frontier.
+	int maze_size;			// Cells are indexed by CELL_INDEX(cell, maze_size).
+
+	// Counters since the frontier was created or last cleared, see collect_frontier_stats().
+	long pushes, pops, decrease_keys;
+	int max_count;			// Largest 'count' reached.
+
+	// d-ary heap backend.
+	node_t *heap;			// Array backed d-ary heap. heap[0] always holds the node with the highest priority.
+	int capacity;			// Allocated length of 'heap'.
+	int arity;				// Children per heap node (2 or 4).
+	int *position;			// Heap slot of every cell, -1 while the cell is not in the frontier.
+
+	// Bucket (Dial) queue backend.
+	node_t **buckets;		// Circular array of node lists, a node of priority p lives in buckets[p & bucket_mask].
+	int bucket_mask;		// Number of buckets - 1 (the number of buckets is a power of two).
+	int cursor;				// Lowest priority that may still be non empty.
+	node_t **handle;		// Bucket node of every cell, NULL while the cell is not in the frontier.
+	node_pool_t pool;		// Where bucket nodes come from.
+}frontier_t;
+
+typedef struct workspace_s {	// Scratch memory of one search, reusable by the next one on the same maze.
+
+	int maze_size;
+	frontier_t *frontier;
+	frontier_t *heap_frontier;	// Binary heap for weighted searches when 'frontier' is a bucket queue, made on first use.
+	uint64_t *visited;		// Closed set, one bit per cell.
+	unsigned char *parent;	// Move that reached each cell, see set_parent().
+	int *cost;				// g(n) of each reached cell.
+	size_t *touched;		// Cells reached since the last reset, so resetting costs as much as the search did.
+	size_t touched_count;
+}workspace_t;
+
+typedef struct search_stats_s {	// Collected on every search, printed with --stats.
+
+	long pushes, pops, decrease_keys;
+	long stale_pops;		// Pops of an already expanded cell, wasted work.
+	int max_frontier;		// Most nodes in the frontier at once.
+	long closed_count;		// Cells expanded.
+	size_t bytes_allocated;	// Frontier, closed set, parents and costs.
+	long setup_ns;			// Allocating or resetting the search memory.
+	long search_ns;
+	long output_ns;			// Rebuilding and printing the route.
+}search_stats_t;
+
+typedef struct search_result_s {
+
+	int goal;				// Exit reached (1 for G1), 0 if none can be reached.
+	coordinates_t goal_cell;
+	int path_cost;			// -1 if no exit can be reached.
+	int expansion_count;
+	long node_reuses;		// See frontier_node_reuses().
+	search_stats_t stats;
+}search_result_t;
+
+typedef struct query_s {
+
+	coordinates_t S;
+	goals_t *goals;
+	search_result_t result;	// Filled in by solve_batch().
+}query_t;
+
 // -----------------------------------
 // 			Priority Queue
 // -----------------------------------
 
-node_t *new_node(coordinates_t new_cell, int new_priority) {
+#define FRONTIER_BINARY_HEAP 0
+#define FRONTIER_QUATERNARY_HEAP 1	// A 4-ary heap is shallower and keeps siblings in one cache line.
+#define FRONTIER_BUCKET_QUEUE 2		// O(1) push and amortized O(1) pop for small integer priorities.
+
+#define HEAP_INITIAL_CAPACITY 64
+
+#define NODE_SLAB_SIZE 1024
+
+node_t *new_node(node_pool_t *pool, coordinates_t new_cell, int new_priority) {
 
 	node_t *new = NULL;
+	node_t **new_slabs = NULL;
 
-	new = (node_t *)malloc(sizeof(node_t));
-	if (new == NULL) {
+	if (pool -> free_list != NULL) {	// Recycle a released node.
 
-		printf("Trouble allocating memory for new node.\n");
-		exit(1);
+		new = pool -> free_list;
+		pool -> free_list = new -> next;
+		pool -> node_reuses++;
 	}
+	else {
 
-	new -> cell = new_cell;
-	new -> priority = new_priority;
-	new -> next = NULL;
-
-	return new;
-}
+		if (pool -> slab_count == 0 || pool -> slab_used == NODE_SLAB_SIZE) {
 
-void push(node_t **head, coordinates_t new_cell, int new_priority) {
+			if (pool -> slab_count == pool -> slab_capacity) {
 
-	node_t *start = (*head);	// 'head' represents the last pushed node.
+				pool -> slab_capacity = (pool -> slab_capacity == 0) ? 16 : 2 * pool -> slab_capacity;
+				new_slabs = (node_t **)realloc(pool -> slabs, pool -> slab_capacity * sizeof(node_t *));
+				if (new_slabs == NULL) {
 
-	node_t *temp = new_node(new_cell, new_priority);
+					printf("Trouble allocating memory for node pool.\n");
+					exit(1);
+				}
+				pool -> slabs = new_slabs;
+			}
 
-	// If the head of the list has lesser priority than the new node,
-	// insert the new node before head and change head node.
-	if ((*head) -> priority > new_priority) {
+			pool -> slabs[pool -> slab_count] = (node_t *)malloc(NODE_SLAB_SIZE * sizeof(node_t));
+			if (pool -> slabs[pool -> slab_count] == NULL) {
 
-		temp -> next = *head;
-		(*head) = temp;
-	}
-	else {
-		// Traverse the list to find new nodes appropriate position (based on the priority of each node).
-		while (start -> next != NULL && start -> next -> priority < new_priority) {
+				printf("Trouble allocating memory for new node.\n");
+				exit(1);
+			}
 
-			start = start -> next;
+			pool -> slab_count++;
+			pool -> slab_used = 0;
 		}
 
-		temp -> next = start -> next;
-		start -> next = temp;
+		new = &(pool -> slabs[pool -> slab_count - 1][pool -> slab_used]);
+		pool -> slab_used++;
 	}
-}
-
-void pop(node_t **head) {
 
-	node_t *temp = *head;
-	(*head) = (*head) -> next;
+	new -> cell = new_cell;
+	new -> priority = new_priority;
+	new -> next = NULL;
+	new -> prev = NULL;
 
-	free(temp);
+	return new;
 }
 
-coordinates_t peek(node_t **head) {	// Return heads coordinates.
+void release_node(node_pool_t *pool, node_t *node) {	// Hand a node back for reuse, its memory stays with the pool.
 
-	return (*head) -> cell;
+	node -> next = pool -> free_list;
+	pool -> free_list = node;
 }
 
-int is_empty(node_t **head) {
-
-	return (*head) == NULL;
-}
+void free_pool(node_pool_t *pool) {
 
-// -----------------------------------
-// 				Maze
-// -----------------------------------
+	int i;
 
-void get_maze_specs(int *maze_size, double *p) {
+	for (i = 0; i < pool -> slab_count; i++) {
 
-	printf("Please, insert maze size: ");
-	scanf("%d", maze_size);
+		free(pool -> slabs[i]);
+	}
 
-	printf("Please, insert cell vecancy probability (0 to 1): ");
-	scanf("%lf", p);
+	free(pool -> slabs);
 
-	if (*p < 0 || *p > 1) {
+	pool -> slabs = NULL;
+	pool -> slab_count = 0;
+	pool -> slab_capacity = 0;
+	pool -> free_list = NULL;
+}
 
-		printf("Vecancy probability should be greater than zero and less than one (0 <= p <= 1).\n");
-		exit(1);
-	}
+long frontier_node_reuses(frontier_t *frontier) {	// Bucket nodes recycled by the pool, 0 for the heaps, which store nodes in place.
 
-	return;
+	return frontier -> pool.node_reuses;
 }
 
-int **create_maze(int maze_size) {
+frontier_t *new_frontier(int type, int maze_size) {
 
-	int i;
-	int **maze = NULL;
+	frontier_t *new = NULL;
+	size_t i, cell_count = (size_t)maze_size * maze_size;
+	int bucket_count = 1;
 
-	maze = (int **)malloc(maze_size * sizeof(int*));
-	if (maze == NULL) {
+	new = (frontier_t *)calloc(1, sizeof(frontier_t));
+	if (new == NULL) {
 
-		printf("Trouble allocating memory for maze.\n");
+		printf("Trouble allocating memory for search frontier.\n");
 		exit(1);
 	}
 
-	for(i = 0; i < maze_size; i++) {
+	new -> type = type;
+	new -> count = 0;
+	new -> maze_size = maze_size;
+
+	if (type == FRONTIER_BINARY_HEAP || type == FRONTIER_QUATERNARY_HEAP) {
 
-		maze[i] = (int *)malloc(maze_size * sizeof(int));
-		if (maze[i] == NULL) {
+		new -> heap = (node_t *)malloc(HEAP_INITIAL_CAPACITY * sizeof(node_t));
+		new -> position = (int *)malloc(cell_count * sizeof(int));
+		if (new -> heap == NULL || new -> position == NULL) {
 
-			printf("Trouble allocating memory for maze (column: %d).\n", i);
+			printf("Trouble allocating memory for search frontier heap.\n");
 			exit(1);
 		}
-	}
-
-	return maze;
-}
 
-void get_coordinates(coordinates_t *S, coordinates_t *G1, coordinates_t *G2, int maze_size) {
+		for (i = 0; i < cell_count; i++) {
 
-	printf("\nStarting cell:\n");
-	while (1) {
+			new -> position[i] = -1;
+		}
 
-		printf("Please, insert x coordinate: ");
-		scanf("%d", &(S->x));
+		new -> capacity = HEAP_INITIAL_CAPACITY;
+		new -> arity = (type == FRONTIER_BINARY_HEAP) ? 2 : 4;
+	}
+	else if (type == FRONTIER_BUCKET_QUEUE) {
 
-		if (S -> x > maze_size - 1 || S -> x < 0) {
+		// Every step costs 1, so priorities never spread further apart than about 2 * maze_size.
+		while (bucket_count < 2 * maze_size + 2) {
 
-			printf("Improper value. 0 <= x < %d\n", maze_size);
-			continue;
+			bucket_count *= 2;
 		}
-		else { break; }
-	}
 
-	while (1) {
+		new -> buckets = (node_t **)calloc(bucket_count, sizeof(node_t *));
+		new -> handle = (node_t **)calloc(cell_count, sizeof(node_t *));
+		if (new -> buckets == NULL || new -> handle == NULL) {
 
-		printf("Please, insert y coordinate: ");
-		scanf("%d", &(S->y));
+			printf("Trouble allocating memory for search frontier buckets.\n");
+			exit(1);
+		}
 
-		if (S -> y > maze_size - 1 || S -> y < 0) {
+		new -> bucket_mask = bucket_count - 1;
+		new -> cursor = 0;
+	}
+	else {
 
-			printf("Improper value. 0 <= y < %d\n", maze_size);
-			continue;
-		}
-		else { break; }
+		printf("Unknown search frontier type %d.\n", type);
+		exit(1);
 	}
 
-	printf("\nExit cell 1:\n");
-	while (1) {
+	return new;
+}
 
-		printf("Please, insert x coordinate: ");
-		scanf("%d", &(G1->x));
+void free_frontier(frontier_t *frontier) {
 
-		if (G1 -> x > maze_size - 1 || G1 -> x < 0) {
+	if (frontier -> type == FRONTIER_BUCKET_QUEUE) {
 
-			printf("Improper value. 0 <= x < %d\n", maze_size);
-			continue;
-		}
-		else { break; }
+		free_pool(&(frontier -> pool));	// Nodes still in the buckets go with their slabs.
+		free(frontier -> buckets);
+		free(frontier -> handle);
 	}
 
-	while (1) {
+	free(frontier -> heap);
+	free(frontier -> position);
+	free(frontier);
+}
 
-		printf("Please, insert y coordinate: ");
-		scanf("%d", &(G1->y));
+void heap_place(frontier_t *frontier, int slot, node_t node) {	// Store a node in a heap slot and remember where it went.
 
-		if (G1 -> y > maze_size - 1 || G1 -> y < 0) {
+	frontier -> heap[slot] = node;
+	frontier -> position[CELL_INDEX(node.cell, frontier -> maze_size)] = slot;
+}
 
-			printf("Improper value. 0 <= y < %d\n", maze_size);
-			continue;
-		}
-		else { break; }
-	}
+void heap_sift_up(frontier_t *frontier, int child, node_t node) {
 
-	printf("\nExit cell 2:\n");
-	while (1) {
+	int parent;
 
-		printf("Please, insert x coordinate: ");
-		scanf("%d", &(G2->x));
+	// Move parents with lesser priority down until the node's slot is found.
+	while (child > 0) {
 
-		if (G2 -> x > maze_size - 1 || G2 -> x < 0) {
+		parent = (child - 1) / frontier -> arity;
+		if (frontier -> heap[parent].priority <= node.priority) {
 
-			printf("Improper value. 0 <= x < %d\n", maze_size);
-			continue;
+			break;
 		}
-		else { break; }
+
+		heap_place(frontier, child, frontier -> heap[parent]);
+		child = parent;
 	}
 
-	while (1) {
+	heap_place(frontier, child, node);
+}
 
-		printf("Please, insert y coordinate: ");
-		scanf("%d", &(G2->y));
+void heap_push(frontier_t *frontier, coordinates_t new_cell, int new_priority) {
 
-		if (G2 -> y > maze_size - 1 || G2 -> y < 0) {
+	node_t *new_heap = NULL;
+	node_t new;
 
-			printf("Improper value. 0 <= y < %d\n", maze_size);
-			continue;
+	if (frontier -> count == frontier -> capacity) {
+
+		new_heap = (node_t *)realloc(frontier -> heap, 2 * frontier -> capacity * sizeof(node_t));
+		if (new_heap == NULL) {
+
+			printf("Trouble reallocating memory for search frontier heap.\n");
+			exit(1);
 		}
-		else { break; }
+
+		frontier -> heap = new_heap;
+		frontier -> capacity *= 2;
 	}
 
-	return;
+	new.cell = new_cell;
+	new.priority = new_priority;
+	new.next = NULL;
+	new.prev = NULL;
+
+	frontier -> count++;
+	heap_sift_up(frontier, frontier -> count - 1, new);
 }
 
-void set_maze_layout(int **maze, int maze_size, double p, coordinates_t S, coordinates_t G1, coordinates_t G2) {
+void heap_pop(frontier_t *frontier) {
 
-	/*	Fills each maze cell with a 0 or a 1 based on a given probability.
-		If a cell is 0, it represents an obstacle and the agent can't pass through.
-		if a cell is 1, it's free.
-	*/
-	int random_probability_i;
-	double random_probability_d;
-	int i, j;
-	
-	srand(time(NULL));
+	node_t last;
+	int parent = 0, child, first_child, last_child, best_child;
 
-	for (i = 0; i < maze_size; i++) {
-		for (j = 0; j < maze_size; j++) {
+	frontier -> position[CELL_INDEX(frontier -> heap[0].cell, frontier -> maze_size)] = -1;
 
-			random_probability_i = rand() % 100;
-			random_probability_d = (double)random_probability_i / 100;
+	frontier -> count--;
+	if (frontier -> count == 0) {
 
-			if (random_probability_d < p) {
+		return;
+	}
 
-				maze[i][j] = 1;
-			}
-			else {
+	// Sift down: the last node takes the root's place and sinks below any child with higher priority.
+	last = frontier -> heap[frontier -> count];
+	while (1) {
 
-				maze[i][j] = 0;
-			}
+		first_child = parent * frontier -> arity + 1;
+		if (first_child >= frontier -> count) {
+
+			break;
 		}
-	}
 
-	if (maze[S.x][S.y] == 0) {
+		last_child = first_child + frontier -> arity;
+		if (last_child > frontier -> count) {
 
-		maze[S.x][S.y] = 1;
-	}
+			last_child = frontier -> count;
+		}
 
-	if (maze[G1.x][G1.y] == 0) {
+		best_child = first_child;
+		for (child = first_child + 1; child < last_child; child++) {
 
-		maze[G1.x][G1.y] = 1;
-	}
+			if (frontier -> heap[child].priority < frontier -> heap[best_child].priority) {
+
+				best_child = child;
+			}
+		}
 
-	if (maze[G2.x][G2.y] == 0) {
+		if (last.priority <= frontier -> heap[best_child].priority) {
+
+			break;
+		}
 
-		maze[G2.x][G2.y] = 1;
+		heap_place(frontier, parent, frontier -> heap[best_child]);
+		parent = best_child;
 	}
 
-	return;
+	heap_place(frontier, parent, last);
 }
 
-void print_maze(int **maze, int maze_size) {
+void bucket_link(frontier_t *frontier, node_t *node) {	// Prepend a node to the bucket of its priority.
 
-	int i, j;
+	int bucket = node -> priority & frontier -> bucket_mask;
 
-	for (i = 0; i < maze_size; i++) {
-		for (j = 0; j < maze_size; j++) {
-			
-			printf("%d ", maze[i][j]);
-		}
+	if (frontier -> count == 0 || node -> priority < frontier -> cursor) {
 
-		printf("\n");
+		frontier -> cursor = node -> priority;
 	}
-}
 
-int find_min(int **maze, int **cell_priority, int maze_size, int i_index, int j_index) {		// Find the minimum cost of neighboring cells.
+	node -> prev = NULL;
+	node -> next = frontier -> buckets[bucket];
+	if (node -> next != NULL) {
 
-	int min_cost = maze_size;
+		node -> next -> prev = node;
+	}
+	frontier -> buckets[bucket] = node;
+}
 
-	// Cell above.
-	if (i_index != 0) {
+void bucket_unlink(frontier_t *frontier, node_t *node) {
 
-		if (cell_priority[i_index - 1][j_index] != 0 && cell_priority[i_index - 1][j_index] < min_cost) {
+	if (node -> prev != NULL) {
 
-			min_cost = cell_priority[i_index - 1][j_index];
-		}
+		node -> prev -> next = node -> next;
 	}
+	else {
 
-	// Cell below.
-	if (i_index != maze_size - 1) {
+		frontier -> buckets[node -> priority & frontier -> bucket_mask] = node -> next;
+	}
 
-		if (cell_priority[i_index + 1][j_index] != 0 && cell_priority[i_index + 1][j_index] < min_cost) {
+	if (node -> next != NULL) {
 
-			min_cost = cell_priority[i_index + 1][j_index];
-		}
+		node -> next -> prev = node -> prev;
 	}
+}
 
-	// Cell to the right.
-	if (j_index != maze_size - 1) {
+void bucket_push(frontier_t *frontier, coordinates_t new_cell, int new_priority) {
 
-		if (cell_priority[i_index][j_index + 1] != 0 && cell_priority[i_index][j_index + 1] < min_cost) {
+	node_t *temp = new_node(&(frontier -> pool), new_cell, new_priority);
 
-			min_cost = cell_priority[i_index][j_index + 1];
-		}
-	}
+	bucket_link(frontier, temp);
+	frontier -> handle[CELL_INDEX(new_cell, frontier -> maze_size)] = temp;
+	frontier -> count++;
+}
 
-	// Cell to the left.
-	if (j_index != 0) {
+void bucket_pop(frontier_t *frontier) {
 
-		if (cell_priority[i_index][j_index - 1] != 0 && cell_priority[i_index][j_index - 1] < min_cost) {
+	node_t *temp = frontier -> buckets[frontier -> cursor & frontier -> bucket_mask];
 
-			min_cost = cell_priority[i_index][j_index - 1];
-		}
-	}
+	bucket_unlink(frontier, temp);
+	frontier -> handle[CELL_INDEX(temp -> cell, frontier -> maze_size)] = NULL;
+	frontier -> count--;
 
-	// Cell to the upper right.
-	if (i_index != 0 && j_index != maze_size - 1) {
+	release_node(&(frontier -> pool), temp);
 
-		if (cell_priority[i_index - 1][j_index + 1] != 0 && cell_priority[i_index - 1][j_index + 1] < min_cost) {
+	// Advance the cursor to the next non empty bucket, so peek() is O(1).
+	if (frontier -> count > 0) {
 
-			min_cost = cell_priority[i_index - 1][j_index + 1];
+		while (frontier -> buckets[frontier -> cursor & frontier -> bucket_mask] == NULL) {
+
+			frontier -> cursor++;
 		}
 	}
+}
 
-	// Cell to the bottom right.
-	if (i_index != maze_size - 1 && j_index != maze_size - 1) {
+void push(frontier_t *frontier, coordinates_t new_cell, int new_priority) {	// 'new_cell' must not already be in the frontier.
 
-		if (cell_priority[i_index + 1][j_index + 1] != 0 && cell_priority[i_index + 1][j_index + 1] < min_cost) {
+	if (frontier -> type == FRONTIER_BUCKET_QUEUE) {
 
-			min_cost = cell_priority[i_index + 1][j_index + 1];
-		}
+		bucket_push(frontier, new_cell, new_priority);
 	}
+	else {
 
-	// Cell to the bottom left.
-	if (i_index != maze_size - 1 && j_index != 0) {
+		heap_push(frontier, new_cell, new_priority);
+	}
 
-		if (cell_priority[i_index + 1][j_index - 1] != 0 && cell_priority[i_index + 1][j_index - 1] < min_cost) {
+	frontier -> pushes++;
+	if (frontier -> count > frontier -> max_count) {
 
-			min_cost = cell_priority[i_index + 1][j_index - 1];
-		}
+		frontier -> max_count = frontier -> count;
 	}
+}
 
-	// Cell to the upper left.
-	if (i_index != 0 && j_index != 0) {
+void pop(frontier_t *frontier) {
 
-		if (cell_priority[i_index - 1][j_index - 1] != 0 && cell_priority[i_index - 1][j_index - 1] < min_cost) {
+	if (frontier -> type == FRONTIER_BUCKET_QUEUE) {
 
-			min_cost = cell_priority[i_index - 1][j_index - 1];
-		}
+		bucket_pop(frontier);
 	}
+	else {
 
-	return min_cost;
-}
+		heap_pop(frontier);
+	}
 
-int **assign_cost(int **maze, int maze_size, coordinates_t S) {		// Assign the g(n) value of every free maze cell.
+	frontier -> pops++;
+}
 
-	int i, i_index, j_index;
-	int **cell_priority = NULL;
-	int cost = 0, min_neighboring_cost = 0;
+coordinates_t peek(frontier_t *frontier) {	// Return heads coordinates.
 
-	cell_priority = (int **)malloc((maze_size * maze_size) * sizeof(int *));
-	if (cell_priority == NULL) {
+	if (frontier -> type == FRONTIER_BUCKET_QUEUE) {
 
-		printf("Trouble allocating memory for cell_priority array.\n");
-		exit(1);
+		return frontier -> buckets[frontier -> cursor & frontier -> bucket_mask] -> cell;
 	}
 
-	for (i = 0; i < maze_size; i++) {
+	return frontier -> heap[0].cell;
+}
 
-		cell_priority[i] = (int *)malloc(maze_size * sizeof(int));
-		if (cell_priority[i] == NULL) {
+int is_empty(frontier_t *frontier) {
 
-			printf("Trouble allocating memory for cell_priority[%d].\n", i);
-			exit(1);
-		}
-	}
+	return frontier -> count == 0;
+}
 
-	if (S.x != 0 && S.y != maze_size) {		// Up right diagonal.
+void clear_frontier(frontier_t *frontier) {	// Empty the frontier, in time proportional to what is left in it.
 
-		i_index = S.x - 1;
-		j_index = S.y + 1;
-		cost = 1; 
+	node_t *temp = NULL;
+	int i;
 
-		cell_priority[i_index][j_index] = 0;
+	frontier -> pushes = 0;
+	frontier -> pops = 0;
+	frontier -> decrease_keys = 0;
+	frontier -> max_count = 0;
+	frontier -> pool.node_reuses = 0;
 
-		while (i_index >= 0 && j_index < maze_size) {
+	if (frontier -> type == FRONTIER_BUCKET_QUEUE) {
 
-			if (maze[i_index][j_index] == 1) {
+		for (i = 0; i <= frontier -> bucket_mask && frontier -> count > 0; i++) {
 
-				(cell_priority[i_index][j_index]) = cost;
+			while (frontier -> buckets[i] != NULL) {
 
+				temp = frontier -> buckets[i];
+				frontier -> buckets[i] = temp -> next;
+				frontier -> handle[CELL_INDEX(temp -> cell, frontier -> maze_size)] = NULL;
+				release_node(&(frontier -> pool), temp);
+				frontier -> count--;
 			}
-			cost++;
-			i_index--;
-			j_index++;
 		}
+
+		return;
 	}
 
-	if (S.x != maze_size && S.y != maze_size) {		// Down right diagonal.
+	for (i = 0; i < frontier -> count; i++) {
 
-		i_index = S.x + 1;
-		j_index = S.y + 1;
-		cost = 1;
+		frontier -> position[CELL_INDEX(frontier -> heap[i].cell, frontier -> maze_size)] = -1;
+	}
 
-		while (i_index < maze_size && j_index < maze_size) {
+	frontier -> count = 0;
+}
 
-			if (maze[i_index][j_index] == 1) {
+int check_frontier(frontier_t *frontier, coordinates_t cell) {	// O(1) membership test through the per cell handles.
 
-				(cell_priority[i_index][j_index]) = cost;
-			}
-			cost++;
-			i_index++;
-			j_index++;
-		}
+	if (frontier -> type == FRONTIER_BUCKET_QUEUE) {
+
+		return frontier -> handle[CELL_INDEX(cell, frontier -> maze_size)] != NULL;
 	}
-	
-	if (S.x != maze_size && S.y != 0) {		// Down left diagonal.
 
-		i_index = S.x + 1;
-		j_index = S.y - 1;
-		cost = 1;
+	return frontier -> position[CELL_INDEX(cell, frontier -> maze_size)] != -1;
+}
 
-		while (i_index < maze_size - 1 && j_index >= 0) {
+int frontier_priority(frontier_t *frontier, coordinates_t cell) {	// Priority of a cell that is in the frontier.
 
-			if (maze[i_index][j_index] == 1) {
+	if (frontier -> type == FRONTIER_BUCKET_QUEUE) {
 
-				(cell_priority[i_index][j_index]) = cost;
-			}		
-			cost++;
-			i_index++;
-			j_index--;
-		}
+		return frontier -> handle[CELL_INDEX(cell, frontier -> maze_size)] -> priority;
 	}
 
-	if (S.x != 0 && S.y != 0) {		// Up left diagonal.
+	return frontier -> heap[frontier -> position[CELL_INDEX(cell, frontier -> maze_size)]].priority;
+}
 
-		i_index = S.x - 1;
-		j_index = S.y - 1;
-		cost = 1;
+int frontier_cells(frontier_t *frontier, coordinates_t *cells) {	// Copy every cell in the frontier to 'cells', in no particular order. Returns how many.
 
-		while (i_index >= 0 && j_index >= 0) {
+	node_t *temp = NULL;
+	int i, count = 0;
+
+	if (frontier -> type == FRONTIER_BUCKET_QUEUE) {
+
+		for (i = 0; i <= frontier -> bucket_mask && count < frontier -> count; i++) {
 
-			if (maze[i_index][j_index] == 1) {
+			for (temp = frontier -> buckets[i]; temp != NULL; temp = temp -> next) {
 
-				(cell_priority[i_index][j_index]) = cost;
+				cells[count++] = temp -> cell;
 			}
-			cost++;
-			i_index--;
-			j_index--;
+		}
+
+		return count;
+	}
+
+	for (i = 0; i < frontier -> count; i++) {
+
+		cells[i] = frontier -> heap[i].cell;
+	}
+
+	return frontier -> count;
+}
+
+void decrease_key(frontier_t *frontier, coordinates_t cell, int new_priority) {	// Raise the priority of a cell already in the frontier, in place.
+
+	node_t *temp = NULL;
+	node_t node;
+	int slot;
+
+	frontier -> decrease_keys++;
+
+	if (frontier -> type == FRONTIER_BUCKET_QUEUE) {
+
+		temp = frontier -> handle[CELL_INDEX(cell, frontier -> maze_size)];
+
+		bucket_unlink(frontier, temp);
+		temp -> priority = new_priority;
+		bucket_link(frontier, temp);
+
+		return;
+	}
+
+	slot = frontier -> position[CELL_INDEX(cell, frontier -> maze_size)];
+	node = frontier -> heap[slot];
+	node.priority = new_priority;
+
+	heap_sift_up(frontier, slot, node);
+}
+
+size_t frontier_bytes(frontier_t *frontier) {	// Memory held by the frontier right now.
+
+	size_t cell_count = (size_t)frontier -> maze_size * frontier -> maze_size;
+
+	if (frontier -> type == FRONTIER_BUCKET_QUEUE) {
+
+		return sizeof(frontier_t) + (frontier -> bucket_mask + 1) * sizeof(node_t *) + cell_count * sizeof(node_t *)
+			+ frontier -> pool.slab_capacity * sizeof(node_t *) + (size_t)frontier -> pool.slab_count * NODE_SLAB_SIZE * sizeof(node_t);
+	}
+
+	return sizeof(frontier_t) + frontier -> capacity * sizeof(node_t) + cell_count * sizeof(int);
+}
+
+void collect_frontier_stats(frontier_t *frontier, search_stats_t *stats) {	// Add the frontier's counters to 'stats'.
+
+	stats -> pushes += frontier -> pushes;
+	stats -> pops += frontier -> pops;
+	stats -> decrease_keys += frontier -> decrease_keys;
+	stats -> max_frontier += frontier -> max_count;
+	stats -> bytes_allocated += frontier_bytes(frontier);
+}
+
+long now_ns() {
+
+	struct timespec now;
+
+	clock_gettime(CLOCK_MONOTONIC, &now);
+	return now.tv_sec * 1000000000L + now.tv_nsec;
+}
+
+int show_stats = 0;		// Print every search's stats, set by --stats.
+
+void print_search_stats(search_stats_t *stats) {
+
+	printf("Pushes: %ld, pops: %ld (%ld stale), decrease keys: %ld.\n", stats -> pushes, stats -> pops, stats -> stale_pops, stats -> decrease_keys);
+	printf("Largest frontier: %d, expanded cells: %ld, search memory: %zu bytes.\n", stats -> max_frontier, stats -> closed_count, stats -> bytes_allocated);
+	printf("Setup: %ld ns, search: %ld ns, output: %ld ns.\n", stats -> setup_ns, stats -> search_ns, stats -> output_ns);
+}
+
+// -----------------------------------
+// 				Maze
+// -----------------------------------
+
+void get_maze_specs(int *maze_size, double *p, uint64_t *seed) {
+
+	printf("Please, insert maze size: ");
+	scanf("%d", maze_size);
+
+	printf("Please, insert cell vecancy probability (0 to 1): ");
+	scanf("%lf", p);
+
+	if (*p < 0 || *p > 1) {
+
+		printf("Vecancy probability should be greater than zero and less than one (0 <= p <= 1).\n");
+		exit(1);
+	}
+
+	printf("Please, insert maze seed (0 for a random one): ");
+	scanf("%" SCNu64, seed);
+
+	if (*seed == 0) {
+
+		*seed = (uint64_t)time(NULL);
+		printf("Maze seed: %" PRIu64 "\n", *seed);
+	}
+
+	return;
+}
+
+int get_frontier_type() {
+
+	int frontier_type;
+
+	printf("Please, select search frontier (%d: binary heap, %d: 4-ary heap, %d: bucket queue): ", FRONTIER_BINARY_HEAP, FRONTIER_QUATERNARY_HEAP, FRONTIER_BUCKET_QUEUE);
+	scanf("%d", &frontier_type);
+
+	if (frontier_type < FRONTIER_BINARY_HEAP || frontier_type > FRONTIER_BUCKET_QUEUE) {
+
+		printf("Unknown search frontier %d.\n", frontier_type);
+		exit(1);
+	}
+
+	return frontier_type;
+}
+
+maze_t *create_maze(int maze_size) {
+
+	maze_t *maze = NULL;
+	void *cells = NULL;
+
+	maze = (maze_t *)malloc(sizeof(maze_t));
+	if (maze == NULL) {
+
+		printf("Trouble allocating memory for maze.\n");
+		exit(1);
+	}
+
+	maze -> size = maze_size;
+	maze -> stride = (maze_size + 63) / 64;
+
+	// A single cache line aligned buffer for the whole grid instead of one allocation per row.
+	if (posix_memalign(&cells, 64, (size_t)maze_size * maze -> stride * sizeof(uint64_t) + 64) != 0) {
+
+		printf("Trouble allocating memory for maze cells.\n");
+		exit(1);
+	}
+
+	maze -> cells = (uint64_t *)cells;
+	maze -> mapping = NULL;
+	maze -> mapping_length = 0;
+	maze -> component = NULL;
+	maze -> component_count = 0;
+	memset(maze -> cells, 0, (size_t)maze_size * maze -> stride * sizeof(uint64_t));
+
+	return maze;
+}
+
+void free_maze(maze_t *maze) {
+
+	if (maze -> mapping != NULL) {
+
+		munmap(maze -> mapping, maze -> mapping_length);
+	}
+	else {
+
+		free(maze -> cells);
+	}
+
+	free(maze -> component);
+	free(maze);
+}
+
+int maze_cell(maze_t *maze, int x, int y) {	// 1 if cell [x][y] is free, 0 if it's an obstacle.
+
+	return (maze -> cells[(size_t)x * maze -> stride + (y >> 6)] >> (y & 63)) & 1;
+}
+
+void set_maze_cell(maze_t *maze, int x, int y, int value) {
+
+	uint64_t bit = (uint64_t)1 << (y & 63);
+
+	// Opening or closing a cell can join or split components, drop the labels.
+	if (maze -> component != NULL) {
+
+		free(maze -> component);
+		maze -> component = NULL;
+	}
+
+	if (value) {
+
+		maze -> cells[(size_t)x * maze -> stride + (y >> 6)] |= bit;
+	}
+	else {
+
+		maze -> cells[(size_t)x * maze -> stride + (y >> 6)] &= ~bit;
+	}
+}
+
+void get_cell(coordinates_t *cell, int maze_size) {
+
+	while (1) {
+
+		printf("Please, insert x coordinate: ");
+		scanf("%d", &(cell->x));
+
+		if (cell -> x > maze_size - 1 || cell -> x < 0) {
+
+			printf("Improper value. 0 <= x < %d\n", maze_size);
+			continue;
+		}
+		else { break; }
+	}
+
+	while (1) {
+
+		printf("Please, insert y coordinate: ");
+		scanf("%d", &(cell->y));
+
+		if (cell -> y > maze_size - 1 || cell -> y < 0) {
+
+			printf("Improper value. 0 <= y < %d\n", maze_size);
+			continue;
+		}
+		else { break; }
+	}
+
+	return;
+}
+
+coordinates_t *get_coordinates(coordinates_t *S, int *goal_count, int maze_size) {	// Returns the exit cells.
+
+	coordinates_t *goal_cells = NULL;
+	int i;
+
+	printf("\nStarting cell:\n");
+	get_cell(S, maze_size);
+
+	printf("\nPlease, insert number of exit cells: ");
+	scanf("%d", goal_count);
+
+	if (*goal_count < 1) {
+
+		printf("There should be at least one exit cell.\n");
+		exit(1);
+	}
+
+	goal_cells = (coordinates_t *)malloc(*goal_count * sizeof(coordinates_t));
+	if (goal_cells == NULL) {
+
+		printf("Trouble allocating memory for exit cells.\n");
+		exit(1);
+	}
+
+	for (i = 0; i < *goal_count; i++) {
+
+		printf("\nExit cell %d:\n", i + 1);
+		get_cell(&(goal_cells[i]), maze_size);
+	}
+
+	return goal_cells;
+}
+
+uint64_t cell_random(uint64_t seed, int x, int y) {	// Counter based: the same (seed, x, y) always gives the same value.
+
+	// splitmix64 finalizer over the cell's position, offset by the seed.
+	uint64_t z = seed + ((uint64_t)x << 32 | (uint32_t)y) * 0x9E3779B97F4A7C15ULL;
+
+	z = (z ^ (z >> 30)) * 0xBF58476D1CE4E5B9ULL;
+	z = (z ^ (z >> 27)) * 0x94D049BB133111EBULL;
+
+	return z ^ (z >> 31);
+}
+
+typedef struct layout_job_s {
+
+	maze_t *maze;
+	double p;
+	uint64_t seed;
+	int first_row, last_row;	// Rows [first_row, last_row) are filled by this job.
+}layout_job_t;
+
+void *fill_maze_rows(void *argument) {
+
+	layout_job_t *job = (layout_job_t *)argument;
+	maze_t *maze = job -> maze;
+	uint64_t word;
+	int x, y, w;
+
+	// Rows start on a word boundary, so jobs never write to the same word.
+	for (x = job -> first_row; x < job -> last_row; x++) {
+		for (w = 0; w < maze -> stride; w++) {
+
+			word = 0;
+			for (y = w * 64; y < (w + 1) * 64 && y < maze -> size; y++) {
+
+				// Top 53 bits as a fraction in [0, 1).
+				if ((double)(cell_random(job -> seed, x, y) >> 11) * 0x1.0p-53 < job -> p) {
+
+					word |= (uint64_t)1 << (y & 63);
+				}
+			}
+
+			maze -> cells[(size_t)x * maze -> stride + w] = word;
+		}
+	}
+
+	return NULL;
+}
+
+void set_maze_layout(maze_t *maze, double p, uint64_t seed, int thread_count, coordinates_t S, goals_t *goals) {
+
+	/*	Fills each maze cell with a 0 or a 1 based on a given probability.
+		If a cell is 0, it represents an obstacle and the agent can't pass through.
+		if a cell is 1, it's free.
+		Each cell only depends on 'seed' and its position, so the same seed and p give the same maze
+		for any 'thread_count'.
+	*/
+	pthread_t *threads = NULL;
+	layout_job_t *jobs = NULL;
+	int i, maze_size = maze -> size;
+
+	if (thread_count < 1) {
+
+		thread_count = 1;
+	}
+
+	if (thread_count > maze_size) {
+
+		thread_count = maze_size;
+	}
+
+	threads = (pthread_t *)malloc(thread_count * sizeof(pthread_t));
+	jobs = (layout_job_t *)malloc(thread_count * sizeof(layout_job_t));
+	if (threads == NULL || jobs == NULL) {
+
+		printf("Trouble allocating memory for maze generation.\n");
+		exit(1);
+	}
+
+	for (i = 0; i < thread_count; i++) {
+
+		jobs[i].maze = maze;
+		jobs[i].p = p;
+		jobs[i].seed = seed;
+		jobs[i].first_row = (int)((long)maze_size * i / thread_count);
+		jobs[i].last_row = (int)((long)maze_size * (i + 1) / thread_count);
+
+		if (pthread_create(&(threads[i]), NULL, fill_maze_rows, &(jobs[i])) != 0) {
+
+			printf("Trouble starting maze generation thread %d.\n", i);
+			exit(1);
+		}
+	}
+
+	for (i = 0; i < thread_count; i++) {
+
+		pthread_join(threads[i], NULL);
+	}
+
+	free(threads);
+	free(jobs);
+
+	if (maze_cell(maze, S.x, S.y) == 0) {
+
+		set_maze_cell(maze, S.x, S.y, 1);
+	}
+
+	for (i = 0; i < goals -> count; i++) {
+
+		if (maze_cell(maze, goals -> cells[i].x, goals -> cells[i].y) == 0) {
+
+			set_maze_cell(maze, goals -> cells[i].x, goals -> cells[i].y, 1);
+		}
+	}
+
+	return;
+}
+
+void print_maze(maze_t *maze) {
+
+	int i, j;
+
+	for (i = 0; i < maze -> size; i++) {
+		for (j = 0; j < maze -> size; j++) {
+			
+			printf("%d ", maze_cell(maze, i, j));
+		}
+
+		printf("\n");
+	}
+}
+
+int find_min(int *cell_priority, int maze_size, int i_index, int j_index) {		// Find the minimum cost of neighboring cells.
+
+	int min_cost = maze_size;
+
+	// Cell above.
+	if (i_index != 0) {
+
+		if (cell_priority[(i_index - 1) * maze_size + j_index] != 0 && cell_priority[(i_index - 1) * maze_size + j_index] < min_cost) {
+
+			min_cost = cell_priority[(i_index - 1) * maze_size + j_index];
+		}
+	}
+
+	// Cell below.
+	if (i_index != maze_size - 1) {
+
+		if (cell_priority[(i_index + 1) * maze_size + j_index] != 0 && cell_priority[(i_index + 1) * maze_size + j_index] < min_cost) {
+
+			min_cost = cell_priority[(i_index + 1) * maze_size + j_index];
+		}
+	}
+
+	// Cell to the right.
+	if (j_index != maze_size - 1) {
+
+		if (cell_priority[i_index * maze_size + j_index + 1] != 0 && cell_priority[i_index * maze_size + j_index + 1] < min_cost) {
+
+			min_cost = cell_priority[i_index * maze_size + j_index + 1];
+		}
+	}
+
+	// Cell to the left.
+	if (j_index != 0) {
+
+		if (cell_priority[i_index * maze_size + j_index - 1] != 0 && cell_priority[i_index * maze_size + j_index - 1] < min_cost) {
+
+			min_cost = cell_priority[i_index * maze_size + j_index - 1];
+		}
+	}
+
+	// Cell to the upper right.
+	if (i_index != 0 && j_index != maze_size - 1) {
+
+		if (cell_priority[(i_index - 1) * maze_size + j_index + 1] != 0 && cell_priority[(i_index - 1) * maze_size + j_index + 1] < min_cost) {
+
+			min_cost = cell_priority[(i_index - 1) * maze_size + j_index + 1];
+		}
+	}
+
+	// Cell to the bottom right.
+	if (i_index != maze_size - 1 && j_index != maze_size - 1) {
+
+		if (cell_priority[(i_index + 1) * maze_size + j_index + 1] != 0 && cell_priority[(i_index + 1) * maze_size + j_index + 1] < min_cost) {
+
+			min_cost = cell_priority[(i_index + 1) * maze_size + j_index + 1];
+		}
+	}
+
+	// Cell to the bottom left.
+	if (i_index != maze_size - 1 && j_index != 0) {
+
+		if (cell_priority[(i_index + 1) * maze_size + j_index - 1] != 0 && cell_priority[(i_index + 1) * maze_size + j_index - 1] < min_cost) {
+
+			min_cost = cell_priority[(i_index + 1) * maze_size + j_index - 1];
+		}
+	}
+
+	// Cell to the upper left.
+	if (i_index != 0 && j_index != 0) {
+
+		if (cell_priority[(i_index - 1) * maze_size + j_index - 1] != 0 && cell_priority[(i_index - 1) * maze_size + j_index - 1] < min_cost) {
+
+			min_cost = cell_priority[(i_index - 1) * maze_size + j_index - 1];
+		}
+	}
+
+	return min_cost;
+}
+
+int *assign_cost(maze_t *maze, coordinates_t S) {		// Assign the g(n) value of every free maze cell, indexed by CELL_INDEX.
+
+	int i_index, j_index, maze_size = maze -> size;
+	int *cell_priority = NULL;
+	int cost = 0, min_neighboring_cost = 0;
+
+	cell_priority = (int *)calloc((size_t)maze_size * maze_size, sizeof(int));
+	if (cell_priority == NULL) {
+
+		printf("Trouble allocating memory for cell_priority array.\n");
+		exit(1);
+	}
+
+	if (S.x != 0 && S.y != maze_size) {		// Up right diagonal.
+
+		i_index = S.x - 1;
+		j_index = S.y + 1;
+		cost = 1; 
+
+		while (i_index >= 0 && j_index < maze_size) {
+
+			if (maze_cell(maze, i_index, j_index) == 1) {
+
+				(cell_priority[i_index * maze_size + j_index]) = cost;
+
+			}
+			cost++;
+			i_index--;
+			j_index++;
+		}
+	}
+
+	if (S.x != maze_size && S.y != maze_size) {		// Down right diagonal.
+
+		i_index = S.x + 1;
+		j_index = S.y + 1;
+		cost = 1;
+
+		while (i_index < maze_size && j_index < maze_size) {
+
+			if (maze_cell(maze, i_index, j_index) == 1) {
+
+				(cell_priority[i_index * maze_size + j_index]) = cost;
+			}
+			cost++;
+			i_index++;
+			j_index++;
+		}
+	}
+	
+	if (S.x != maze_size && S.y != 0) {		// Down left diagonal.
+
+		i_index = S.x + 1;
+		j_index = S.y - 1;
+		cost = 1;
+
+		while (i_index < maze_size - 1 && j_index >= 0) {
+
+			if (maze_cell(maze, i_index, j_index) == 1) {
+
+				(cell_priority[i_index * maze_size + j_index]) = cost;
+			}		
+			cost++;
+			i_index++;
+			j_index--;
+		}
+	}
+
+	if (S.x != 0 && S.y != 0) {		// Up left diagonal.
+
+		i_index = S.x - 1;
+		j_index = S.y - 1;
+		cost = 1;
+
+		while (i_index >= 0 && j_index >= 0) {
+
+			if (maze_cell(maze, i_index, j_index) == 1) {
+
+				(cell_priority[i_index * maze_size + j_index]) = cost;
+			}
+			cost++;
+			i_index--;
+			j_index--;
 		}
 	}
 
 	if (S.x != 0) {				// Up.
 
-		i_index = S.x - 1;
-		j_index = S.y;
-		cost = 1;
+		i_index = S.x - 1;
+		j_index = S.y;
+		cost = 1;
+
+		while (i_index >= 0) {
+
+			if (maze_cell(maze, i_index, j_index) == 1) {
+
+				(cell_priority[i_index * maze_size + j_index]) = cost;
+			}
+			cost++;
+			i_index--;
+		}
+	}
+
+	if (S.x != maze_size) {		// Down.
+
+		i_index = S.x + 1;
+		j_index = S.y;
+		cost = 1;
+
+		while (i_index < maze_size) {
+
+			if (maze_cell(maze, i_index, j_index) == 1) {
+
+				(cell_priority[i_index * maze_size + j_index]) = cost;
+			}
+			cost++;
+			i_index++;
+		}
+	}
+
+	if (S.y != 0) {		// Left.
+
+		i_index = S.x;
+		j_index = S.y - 1;
+		cost = 1;
+
+		while (j_index >= 0) {
+
+			if (maze_cell(maze, i_index, j_index) == 1) {
+
+				(cell_priority[i_index * maze_size + j_index]) = cost;
+			}
+			cost++;
+			j_index--;
+		}
+	}
+
+	if (S.y != maze_size) {		// Right.
+
+		i_index = S.x;
+		j_index = S.y + 1;
+		cost = 1;
+
+		while (j_index < maze_size) {
+
+			if (maze_cell(maze, i_index, j_index) == 1) {
+
+				(cell_priority[i_index * maze_size + j_index]) = cost;
+			}
+			cost++;
+			j_index++;
+		}
+	}
+
+	for (i_index = 0; i_index < S.x; i_index++) {					// Upper right quarter.
+		for (j_index = S.y + 1; j_index < maze_size; j_index++) {
+
+			if (maze_cell(maze, i_index, j_index) == 1 && cell_priority[i_index * maze_size + j_index] == 0) {
+
+				min_neighboring_cost = find_min(cell_priority, maze_size, i_index, j_index);
+				cell_priority[i_index * maze_size + j_index] = min_neighboring_cost + 1;
+				//printf("Assigning cell_priority[%d * maze_size + %d] to %d.\n", i_index, j_index, cell_priority[i_index * maze_size + j_index]);
+			}
+		}
+	}
+
+	for (i_index = 0; i_index < S.x; i_index++) {					// Upper left quarter.
+		for (j_index = S.y - 1; j_index >= 0; j_index--) {
+
+			if (maze_cell(maze, i_index, j_index) == 1 && cell_priority[i_index * maze_size + j_index] == 0) {
+
+				min_neighboring_cost = find_min(cell_priority, maze_size, i_index, j_index);
+				cell_priority[i_index * maze_size + j_index] = min_neighboring_cost + 1;
+				//printf("Assigning cell_priority[%d * maze_size + %d] to %d.\n", i_index, j_index, cell_priority[i_index * maze_size + j_index]);
+			}
+		}
+	}
+
+	for (i_index = S.x + 1; i_index < maze_size; i_index++) {		// Bottom right quarter.
+		for (j_index = S.y + 1; j_index < maze_size; j_index++) {
+
+			if (maze_cell(maze, i_index, j_index) == 1 && cell_priority[i_index * maze_size + j_index] == 0) {
+
+				min_neighboring_cost = find_min(cell_priority, maze_size, i_index, j_index);
+				cell_priority[i_index * maze_size + j_index] = min_neighboring_cost + 1;
+				//printf("Assigning cell_priority[%d * maze_size + %d] to %d.\n", i_index, j_index, cell_priority[i_index * maze_size + j_index]);
+			}
+		}
+	}
+
+	for (i_index = S.x + 1; i_index < maze_size; i_index++) {		// Bottom left quarter.
+		for (j_index = S.y - 1; j_index >= 0; j_index--) {
+
+			if (maze_cell(maze, i_index, j_index) == 1 && cell_priority[i_index * maze_size + j_index] == 0) {
+
+				min_neighboring_cost = find_min(cell_priority, maze_size, i_index, j_index);
+				cell_priority[i_index * maze_size + j_index] = min_neighboring_cost + 1;
+				//printf("Assigning cell_priority[%d * maze_size + %d] to %d.\n", i_index, j_index, cell_priority[i_index * maze_size + j_index]);
+			}
+		}		
+	}
+	/*
+	printf("Cell Priority:\n");
+
+	for (i_index = 0; i_index < maze_size; i_index++) {
+		for (j_index = 0; j_index < maze_size; j_index++) {
+
+			printf("%d ", cell_priority[i_index * maze_size + j_index]);
+		}
+		printf("\n");
+	}
+	*/
+	return cell_priority;
+}
+
+// -----------------------------------
+// 			  Maze Files
+// -----------------------------------
+
+/*	Binary maze file, all fields in native byte order:
+		maze_file_header_t
+		goal_count exit cells, as coordinates_t
+		zero padding up to 'cells_offset' (a multiple of 64)
+		size * stride 64 bit words, the rows exactly as maze_t keeps them in memory
+	so load_maze() maps the file and searches it in place, pages are read in as the search reaches them.
+*/
+#define MAZE_FILE_MAGIC "MAZEBIN1"
+
+typedef struct maze_file_header_s {
+
+	char magic[8];			// MAZE_FILE_MAGIC, without the terminating '\0'.
+	int32_t size;
+	int32_t stride;
+	int32_t goal_count;
+	coordinates_t S;
+	uint64_t cells_offset;	// Byte offset of the first row, 64 byte aligned.
+}maze_file_header_t;
+
+void save_maze(maze_t *maze, coordinates_t S, coordinates_t *goal_cells, int goal_count, char *file_name) {
+
+	maze_file_header_t header;
+	FILE *file = NULL;
+	char padding[64] = {0};
+	size_t cells_length = (size_t)maze -> size * maze -> stride * sizeof(uint64_t);
+	uint64_t written;
+
+	memcpy(header.magic, MAZE_FILE_MAGIC, sizeof(header.magic));
+	header.size = maze -> size;
+	header.stride = maze -> stride;
+	header.goal_count = goal_count;
+	header.S = S;
+	header.cells_offset = (sizeof(header) + goal_count * sizeof(coordinates_t) + 63) & ~(uint64_t)63;
+
+	file = fopen(file_name, "wb");
+	if (file == NULL) {
+
+		printf("Trouble opening maze file %s.\n", file_name);
+		exit(1);
+	}
+
+	written = sizeof(header) + goal_count * sizeof(coordinates_t);
+	if (fwrite(&header, sizeof(header), 1, file) != 1
+		|| fwrite(goal_cells, sizeof(coordinates_t), goal_count, file) != (size_t)goal_count
+		|| fwrite(padding, 1, header.cells_offset - written, file) != header.cells_offset - written
+		|| fwrite(maze -> cells, 1, cells_length, file) != cells_length
+		|| fclose(file) != 0) {
+
+		printf("Trouble writing maze file %s.\n", file_name);
+		exit(1);
+	}
+}
+
+maze_t *load_maze(char *file_name, coordinates_t *S, coordinates_t **goal_cells, int *goal_count) {
+
+	/*	Maps a file written by save_maze(). The maze is mapped privately, so set_maze_cell() still works
+		and never writes back to the file. Returns the maze, S and a copy of the exit cells.
+	*/
+	maze_file_header_t *header = NULL;
+	maze_t *maze = NULL;
+	struct stat file_stat;
+	coordinates_t cell;
+	void *mapping = NULL;
+	int file, i;
+
+	file = open(file_name, O_RDONLY);
+	if (file < 0 || fstat(file, &file_stat) != 0) {
+
+		printf("Trouble opening maze file %s.\n", file_name);
+		exit(1);
+	}
+
+	if ((size_t)file_stat.st_size < sizeof(maze_file_header_t)) {
+
+		printf("%s is not a maze file.\n", file_name);
+		exit(1);
+	}
+
+	mapping = mmap(NULL, file_stat.st_size, PROT_READ | PROT_WRITE, MAP_PRIVATE, file, 0);
+	close(file);
+	if (mapping == MAP_FAILED) {
+
+		printf("Trouble mapping maze file %s.\n", file_name);
+		exit(1);
+	}
+
+	header = (maze_file_header_t *)mapping;
+	if (memcmp(header -> magic, MAZE_FILE_MAGIC, sizeof(header -> magic)) != 0
+		|| header -> size < 1 || header -> stride != (header -> size + 63) / 64 || header -> goal_count < 1
+		|| (header -> cells_offset & 63) != 0
+		|| header -> cells_offset < sizeof(maze_file_header_t) + header -> goal_count * sizeof(coordinates_t)
+		|| header -> cells_offset + (uint64_t)header -> size * header -> stride * sizeof(uint64_t) > (uint64_t)file_stat.st_size) {
+
+		printf("%s is not a maze file.\n", file_name);
+		exit(1);
+	}
+
+	maze = (maze_t *)malloc(sizeof(maze_t));
+	*goal_cells = (coordinates_t *)malloc(header -> goal_count * sizeof(coordinates_t));
+	if (maze == NULL || *goal_cells == NULL) {
+
+		printf("Trouble allocating memory for maze.\n");
+		exit(1);
+	}
+
+	maze -> size = header -> size;
+	maze -> stride = header -> stride;
+	maze -> cells = (uint64_t *)((char *)mapping + header -> cells_offset);
+	maze -> mapping = mapping;
+	maze -> mapping_length = file_stat.st_size;
+	maze -> component = NULL;
+	maze -> component_count = 0;
+
+	*S = header -> S;
+	*goal_count = header -> goal_count;
+	memcpy(*goal_cells, (char *)mapping + sizeof(maze_file_header_t), header -> goal_count * sizeof(coordinates_t));
+
+	for (i = -1; i < *goal_count; i++) {
+
+		cell = (i < 0) ? *S : (*goal_cells)[i];
+		if (cell.x < 0 || cell.x >= maze -> size || cell.y < 0 || cell.y >= maze -> size) {
+
+			printf("%s is not a maze file.\n", file_name);
+			exit(1);
+		}
+	}
+
+	return maze;
+}
+
+// -----------------------------------
+// 		  Connected Components
+// -----------------------------------
+
+uint32_t find_root(uint32_t *root, uint32_t cell) {	// Union-find lookup, halving the path on the way up.
+
+	while (root[cell] != cell) {
+
+		root[cell] = root[root[cell]];
+		cell = root[cell];
+	}
+
+	return cell;
+}
+
+void join_cells(uint32_t *root, uint32_t a, uint32_t b) {	// Union, the smaller index stays the root.
+
+	a = find_root(root, a);
+	b = find_root(root, b);
+
+	if (a < b) {
+
+		root[b] = a;
+	}
+	else if (b < a) {
+
+		root[a] = b;
+	}
+}
+
+void label_components(maze_t *maze) {
+
+	/*	Labels every free cell with its 8-connected component (1, 2, ...), obstacles get 0.
+		One raster scan joins each free cell with its already scanned neighbours (up-left, up, up-right, left),
+		always keeping the smaller index as the root, so every cell's parent comes before it and a second scan
+		can turn each parent index into its label in place. The union-find roots live in the label array itself,
+		4 bytes per cell in all. The labels stay with the maze until a cell changes.
+	*/
+	uint32_t *root = NULL;
+	uint32_t cell;
+	size_t cell_count = (size_t)maze -> size * maze -> size;
+	int maze_size = maze -> size;
+	int x, y, up, up_left, up_right, left;
+
+	if (cell_count > UINT32_MAX) {
+
+		printf("Can't label the components of a maze over %u cells.\n", UINT32_MAX);
+		exit(1);
+	}
+
+	free(maze -> component);
+	maze -> component = (uint32_t *)malloc(cell_count * sizeof(uint32_t));
+	if (maze -> component == NULL) {
+
+		printf("Trouble allocating memory for maze components.\n");
+		exit(1);
+	}
+	root = maze -> component;
+
+	for (x = 0; x < maze_size; x++) {
+		for (y = 0; y < maze_size; y++) {
+
+			cell = (uint32_t)x * maze_size + y;
+			root[cell] = cell;
+
+			if (maze_cell(maze, x, y) == 0) {
+
+				continue;
+			}
+
+			up = x > 0 && maze_cell(maze, x - 1, y);
+			up_left = x > 0 && y > 0 && maze_cell(maze, x - 1, y - 1);
+			up_right = x > 0 && y + 1 < maze_size && maze_cell(maze, x - 1, y + 1);
+			left = y > 0 && maze_cell(maze, x, y - 1);
+
+			// Up touches the other three, so they already share its component. Likewise up-left touches left.
+			if (up) {
+
+				join_cells(root, cell, cell - maze_size);
+				continue;
+			}
+
+			if (up_left) {
+
+				join_cells(root, cell, cell - maze_size - 1);
+			}
+			else if (left) {
+
+				join_cells(root, cell, cell - 1);
+			}
+
+			if (up_right) {
+
+				join_cells(root, cell, cell - maze_size + 1);
+			}
+		}
+	}
+
+	maze -> component_count = 0;
+	for (x = 0; x < maze_size; x++) {
+		for (y = 0; y < maze_size; y++) {
+
+			cell = (uint32_t)x * maze_size + y;
+
+			if (maze_cell(maze, x, y) == 0) {
+
+				maze -> component[cell] = 0;
+			}
+			else if (root[cell] == cell) {
+
+				maze -> component[cell] = ++(maze -> component_count);
+			}
+			else {
+
+				// The parent comes first in raster order and shares the component, so it is already labeled.
+				maze -> component[cell] = maze -> component[root[cell]];
+			}
+		}
+	}
+}
+
+int can_reach(maze_t *maze, coordinates_t S, goals_t *goals) {	// 0 only if no exit shares S's component, 1 if unsure.
+
+	uint32_t start_component;
+	int i;
+
+	if (maze -> component == NULL) {
+
+		return 1;
+	}
+
+	start_component = maze -> component[CELL_INDEX(S, maze -> size)];
+	if (start_component == 0) {	// S on an obstacle, leave it to the search.
+
+		return 1;
+	}
+
+	for (i = 0; i < goals -> count; i++) {
+
+		if (maze -> component[CELL_INDEX(goals -> cells[i], maze -> size)] == start_component) {
+
+			return 1;
+		}
+	}
+
+	return 0;
+}
+
+void set_unreachable(search_result_t *result) {	// The result of a search that was never started, see can_reach().
+
+	result -> goal = 0;
+	result -> path_cost = -1;
+	result -> expansion_count = 0;
+	result -> node_reuses = 0;
+	memset(&(result -> stats), 0, sizeof(search_stats_t));
+}
+
+// -----------------------------------
+// 				Goals
+// -----------------------------------
+
+#define GOAL_FIELD_THRESHOLD 8		// With more exits than this, a precomputed nearest exit field beats looping over them.
+
+void relax_distance(int *d, size_t cell, size_t neighbour) {	// d[cell] = min(d[cell], d[neighbour] + 1).
+
+	if (d[neighbour] + 1 < d[cell]) {
+
+		d[cell] = d[neighbour] + 1;
+	}
+}
+
+void build_nearest_goal_field(goals_t *goals) {
+
+	/*	Chebyshev distance transform: one pass down and right, one pass up and left, each taking the
+		minimum over the already visited half of the 8 neighbors. Walls are ignored, so the field is a
+		lower bound on the true distance to the closest exit, computed once in O(cells).
+	*/
+	int maze_size = goals -> maze_size;
+	int x, y, i, *d = NULL;
+	size_t cell;
+
+	d = (int *)malloc((size_t)maze_size * maze_size * sizeof(int));
+	if (d == NULL) {
+
+		printf("Trouble allocating memory for nearest exit field.\n");
+		exit(1);
+	}
+
+	for (x = 0; x < maze_size; x++) {
+		for (y = 0; y < maze_size; y++) {
+
+			d[(size_t)x * maze_size + y] = 2 * maze_size;
+		}
+	}
+
+	for (i = 0; i < goals -> count; i++) {
+
+		d[CELL_INDEX(goals -> cells[i], maze_size)] = 0;
+	}
+
+	for (x = 0; x < maze_size; x++) {
+		for (y = 0; y < maze_size; y++) {
+
+			cell = (size_t)x * maze_size + y;
+
+			if (x > 0 && y > 0) {
+
+				relax_distance(d, cell, cell - maze_size - 1);
+			}
+
+			if (x > 0) {
+
+				relax_distance(d, cell, cell - maze_size);
+			}
+
+			if (x > 0 && y < maze_size - 1) {
+
+				relax_distance(d, cell, cell - maze_size + 1);
+			}
+
+			if (y > 0) {
+
+				relax_distance(d, cell, cell - 1);
+			}
+		}
+	}
+
+	for (x = maze_size - 1; x >= 0; x--) {
+		for (y = maze_size - 1; y >= 0; y--) {
+
+			cell = (size_t)x * maze_size + y;
+
+			if (x < maze_size - 1 && y < maze_size - 1) {
+
+				relax_distance(d, cell, cell + maze_size + 1);
+			}
+
+			if (x < maze_size - 1) {
+
+				relax_distance(d, cell, cell + maze_size);
+			}
+
+			if (x < maze_size - 1 && y > 0) {
+
+				relax_distance(d, cell, cell + maze_size - 1);
+			}
+
+			if (y < maze_size - 1) {
+
+				relax_distance(d, cell, cell + 1);
+			}
+		}
+	}
+
+	goals -> nearest = d;
+}
+
+goals_t *new_goals(coordinates_t *goal_cells, int goal_count, int maze_size) {
+
+	goals_t *goals = NULL;
+	size_t cell_count = (size_t)maze_size * maze_size;
+	int i;
+
+	goals = (goals_t *)malloc(sizeof(goals_t));
+	if (goals == NULL) {
+
+		printf("Trouble allocating memory for exit cells.\n");
+		exit(1);
+	}
+
+	goals -> cells = goal_cells;
+	goals -> count = goal_count;
+	goals -> maze_size = maze_size;
+	goals -> nearest = NULL;
+	goals -> bitmap = NULL;
+	goals -> landmarks = NULL;
+	goals -> landmark_min = NULL;
+	goals -> landmark_max = NULL;
+
+	// A handful of exits is checked directly, which keeps one-exit queries cheap to set up.
+	if (goal_count > GOAL_FIELD_THRESHOLD) {
+
+		goals -> bitmap = (uint64_t *)calloc((cell_count + 63) / 64, sizeof(uint64_t));
+		if (goals -> bitmap == NULL) {
+
+			printf("Trouble allocating memory for exit bitmap.\n");
+			exit(1);
+		}
+
+		for (i = 0; i < goal_count; i++) {
+
+			goals -> bitmap[CELL_INDEX(goal_cells[i], maze_size) >> 6] |= (uint64_t)1 << (CELL_INDEX(goal_cells[i], maze_size) & 63);
+		}
+
+		build_nearest_goal_field(goals);
+	}
+
+	return goals;
+}
+
+void free_goals(goals_t *goals) {	// The exit cells themselves belong to the caller.
+
+	free(goals -> bitmap);
+	free(goals -> nearest);
+	free(goals -> landmark_min);
+	free(goals -> landmark_max);
+	free(goals);
+}
+
+int is_goal(coordinates_t current_node, goals_t *goals) {	// Returns the exit's number (1 for G1), 0 if 'current_node' is not an exit.
+
+	size_t index = CELL_INDEX(current_node, goals -> maze_size);
+	int i;
+
+	if (goals -> bitmap != NULL && ((goals -> bitmap[index >> 6] >> (index & 63)) & 1) == 0) {
+
+		return 0;
+	}
+
+	// With a bitmap, only reached once per search, when an exit is actually found.
+	for (i = 0; i < goals -> count; i++) {
+
+		if (current_node.x == goals -> cells[i].x && current_node.y == goals -> cells[i].y) {
+
+			return i + 1;
+		}
+	}
+
+	return 0;
+}
+
+void print_unreachable(goals_t *goals) {
+
+	int i;
+
+	if (goals -> count > 4) {
+
+		printf("Unable to reach any of the %d exits.\n", goals -> count);
+		return;
+	}
+
+	printf("Unable to reach ");
+	for (i = 0; i < goals -> count; i++) {
+
+		if (i > 0) {
+
+			printf((i == goals -> count - 1) ? " nor " : ", ");
+		}
+		printf("G%d[%d][%d]", i + 1, goals -> cells[i].x, goals -> cells[i].y);
+	}
+	printf(".\n");
+}
+
+// -----------------------------------
+// 	  UCS, A* utility functions
+// -----------------------------------
+
+void print_frontier(frontier_t *search_frontier) {
+
+	node_t *head = NULL;
+	int i;
+
+	printf("Search Frontier: \n");
+
+	if (search_frontier -> type == FRONTIER_BUCKET_QUEUE) {
+
+		for (i = 0; i <= search_frontier -> bucket_mask; i++) {
+			for (head = search_frontier -> buckets[i]; head != NULL; head = head -> next) {
+
+				printf("[Priority: %d] [%d][%d]\n", head -> priority, (head -> cell).x, (head -> cell).y);
+			}
+		}
+
+		return;
+	}
+
+	for (i = 0; i < search_frontier -> count; i++) {
+
+		printf("[Priority: %d] [%d][%d]\n", search_frontier -> heap[i].priority, (search_frontier -> heap[i].cell).x, (search_frontier -> heap[i].cell).y);
+	}
+}
+
+// Transition operators, clockwise starting upwards: up, upper right, right, down right, down, down left, left, upper left.
+const int move_x[8] = {-1, -1, 0, 1, 1, 1, 0, -1};
+const int move_y[8] = {0, 1, 1, 1, 0, -1, -1, -1};
+
+int in_maze(coordinates_t cell, int maze_size) {
+
+	return cell.x >= 0 && cell.x < maze_size && cell.y >= 0 && cell.y < maze_size;
+}
+
+uint64_t *new_bitset(size_t bit_count) {	// One bit per cell, all cleared.
+
+	uint64_t *bitset = NULL;
+
+	bitset = (uint64_t *)calloc((bit_count + 63) / 64, sizeof(uint64_t));
+	if (bitset == NULL) {
+
+		printf("Trouble allocating memory for bitset.\n");
+		exit(1);
+	}
+
+	return bitset;
+}
+
+int is_visited(coordinates_t current_node, uint64_t *visited, int maze_size) {
+
+	size_t index = CELL_INDEX(current_node, maze_size);
+
+	return (visited[index >> 6] >> (index & 63)) & 1;
+}
+
+void push_visited(coordinates_t current_node, uint64_t *visited, int maze_size) {
+
+	size_t index = CELL_INDEX(current_node, maze_size);
+
+	visited[index >> 6] |= (uint64_t)1 << (index & 63);
+}
+
+size_t search_memory_bytes(size_t cell_count) {	// Closed set, parent moves and g(n) of one search over 'cell_count' cells.
+
+	return (cell_count + 63) / 64 * sizeof(uint64_t) + (cell_count + 1) / 2 + cell_count * sizeof(int);
+}
+
+unsigned char *new_parents(size_t cell_count) {	// Half a byte per cell, holding the move that reached it.
+
+	unsigned char *parent = NULL;
+
+	parent = (unsigned char *)malloc((cell_count + 1) / 2);
+	if (parent == NULL) {
+
+		printf("Trouble allocating memory for parent moves.\n");
+		exit(1);
+	}
+
+	return parent;
+}
+
+void set_parent(unsigned char *parent, size_t index, int move) {	// 'move' indexes move_x/move_y, 3 bits are enough.
+
+	if (index & 1) {
+
+		parent[index >> 1] = (parent[index >> 1] & 0x0F) | (move << 4);
+	}
+	else {
+
+		parent[index >> 1] = (parent[index >> 1] & 0xF0) | move;
+	}
+}
+
+int get_parent(unsigned char *parent, size_t index) {
+
+	return (parent[index >> 1] >> ((index & 1) * 4)) & 0x0F;
+}
+
+coordinates_t *reconstruct_path(unsigned char *parent, int maze_size, coordinates_t S, coordinates_t goal, int path_cost) {
+
+	coordinates_t *path = NULL;
+	coordinates_t current = goal;
+	int i, move;
+
+	path = (coordinates_t *)malloc((path_cost + 1) * sizeof(coordinates_t));
+	if (path == NULL) {
+
+		printf("Trouble allocating memory for 'path' array.\n");
+		exit(1);
+	}
+
+	// Walk the parent moves back from the goal, filling the path from its end.
+	for (i = path_cost; i > 0; i--) {
+
+		path[i] = current;
+
+		move = get_parent(parent, CELL_INDEX(current, maze_size));
+		current.x -= move_x[move];
+		current.y -= move_y[move];
+	}
+
+	path[0] = S;
+
+	return path;
+}
+
+void print_path(coordinates_t *path, int path_count) {
+
+	int i;
+
+	printf("Path:\n");
+
+	for (i = 0; i < path_count; i++) {
+
+		if (i > 0 && i % 5 == 0) {
+
+			printf("\n");
+		}
+
+		if (i == path_count - 1) {
+
+			printf("[%d][%d]\n", (path[i]).x, (path[i]).y);
+			break;
+		}
+
+		printf("[%d][%d] -> ", (path[i]).x, (path[i]).y);
+	}
+
+	printf("Path cost: %d.\n", path_count - 1);
+}
+
+int octile_distance(coordinates_t current_coordinates, coordinates_t goal_coordinates, int D, int D2) {
+
+	int dx, dy;
+	int min;
+
+	dx = abs(current_coordinates.x - goal_coordinates.x);
+	dy = abs(current_coordinates.y - goal_coordinates.y);
+
+	if (dx < dy) { min = dx; }
+	else { min = dy; }
+
+	return D * (dx + dy) + (D2 - (2 * D)) * min;
+}
+
+int heuristic(coordinates_t current_coordinates, coordinates_t goal_coordinates) {
+
+	int D = 1;		// Minimum cost for moving from one node to an adjacent node (moving in 4 directions, not counting diagonal movement).
+	int D2 = 1;		// Minimum cost for moving from one node to an adjacent node diagonally.
+
+	return octile_distance(current_coordinates, goal_coordinates, D, D2);
+}
+
+int min_heuristic(int h1, int h2) {
+
+	if (h1 < h2) { return h1; }
+
+	return h2;
+}
+
+int landmark_heuristic(coordinates_t current_coordinates, goals_t *goals) {
+
+	/*	Triangle inequality through every landmark L: the closest exit is at least
+		d(L, closest exit from L) - d(L, n) and d(L, n) - d(L, farthest exit from L) away from n.
+		Both change by at most 1 per move, so the bound is consistent, like the octile distance.
+	*/
+	landmarks_t *landmarks = goals -> landmarks;
+	uint16_t *distance = landmarks -> distance + CELL_INDEX(current_coordinates, goals -> maze_size) * landmarks -> count;
+	int i, h = 0;
+
+	for (i = 0; i < landmarks -> count; i++) {
+
+		if (distance[i] == LANDMARK_UNKNOWN || goals -> landmark_min[i] < 0) {
+
+			continue;
+		}
+
+		if (goals -> landmark_min[i] - distance[i] > h) {
+
+			h = goals -> landmark_min[i] - distance[i];
+		}
+
+		if (distance[i] - goals -> landmark_max[i] > h) {
+
+			h = distance[i] - goals -> landmark_max[i];
+		}
+	}
+
+	return h;
+}
+
+int goal_heuristic(coordinates_t current_coordinates, goals_t *goals) {	// heuristic() to the closest exit.
+
+	int i, h;
+
+	if (goals -> nearest != NULL) {
+
+		h = goals -> nearest[CELL_INDEX(current_coordinates, goals -> maze_size)];
+	}
+	else {
+
+		h = heuristic(current_coordinates, goals -> cells[0]);
+		for (i = 1; i < goals -> count; i++) {
+
+			h = min_heuristic(h, heuristic(current_coordinates, goals -> cells[i]));
+		}
+	}
+
+	// Both bounds hold, so the larger one is still admissible.
+	if (goals -> landmarks != NULL) {
+
+		i = landmark_heuristic(current_coordinates, goals);
+		if (i > h) {
+
+			h = i;
+		}
+	}
+
+	return h;
+}
+
+// -----------------------------------
+// 			  Landmarks
+// -----------------------------------
+
+/*	ALT heuristic (A*, Landmarks, Triangle inequality). A few landmark cells are chosen once per maze and
+	flooded, and the distances from each of them to every cell are kept as 16 bit values. Through the triangle
+	inequality they bound the distance to the exits far more tightly than the octile distance does around walls.
+	The table is valid only as long as the maze doesn't change.
+*/
+#define ALT_LANDMARKS 4		// Landmarks per maze, each costs 2 bytes per cell.
+
+void landmark_flood(maze_t *maze, size_t source, uint32_t *distance, size_t *queue) {	// Breadth first distances from 'source', UINT32_MAX if out of reach.
+
+	size_t cell_count = (size_t)maze -> size * maze -> size, head = 0, tail = 0, cell, next_cell;
+	coordinates_t current, next;
+	int maze_size = maze -> size, move;
+
+	memset(distance, 0xFF, cell_count * sizeof(uint32_t));
+
+	distance[source] = 0;
+	queue[tail++] = source;
+
+	while (head < tail) {
+
+		cell = queue[head++];
+		current.x = (int)(cell / maze_size);
+		current.y = (int)(cell % maze_size);
+
+		for (move = 0; move < 8; move++) {
+
+			next.x = current.x + move_x[move];
+			next.y = current.y + move_y[move];
+
+			if (!in_maze(next, maze_size) || !maze_cell(maze, next.x, next.y)) {
+
+				continue;
+			}
+
+			next_cell = CELL_INDEX(next, maze_size);
+			if (distance[next_cell] == UINT32_MAX) {
+
+				distance[next_cell] = distance[cell] + 1;
+				queue[tail++] = next_cell;
+			}
+		}
+	}
+}
+
+landmarks_t *new_landmarks(maze_t *maze, int count) {
+
+	/*	Farthest first: the first landmark is the cell farthest from a cell of the largest component, and each
+		next one the cell farthest from all the landmarks so far, which spreads them along the maze's edges.
+	*/
+	landmarks_t *landmarks = NULL;
+	uint32_t *distance = NULL, *nearest = NULL, *component_size = NULL;
+	size_t *queue = NULL;
+	size_t cell_count = (size_t)maze -> size * maze -> size, cell, source;
+	uint32_t largest = 0, component;
+	int maze_size = maze -> size, i;
+
+	if (maze -> component == NULL) {
+
+		label_components(maze);
+	}
+
+	landmarks = (landmarks_t *)malloc(sizeof(landmarks_t));
+	distance = (uint32_t *)malloc(cell_count * sizeof(uint32_t));
+	nearest = (uint32_t *)malloc(cell_count * sizeof(uint32_t));
+	queue = (size_t *)malloc(cell_count * sizeof(size_t));
+	component_size = (uint32_t *)calloc(maze -> component_count + 1, sizeof(uint32_t));
+	if (landmarks == NULL || distance == NULL || nearest == NULL || queue == NULL || component_size == NULL) {
+
+		printf("Trouble allocating memory for landmarks.\n");
+		exit(1);
+	}
+
+	landmarks -> count = 0;
+	landmarks -> cells = (coordinates_t *)malloc(count * sizeof(coordinates_t));
+	landmarks -> distance = (uint16_t *)malloc(cell_count * count * sizeof(uint16_t));
+	if (landmarks -> cells == NULL || landmarks -> distance == NULL) {
+
+		printf("Trouble allocating memory for landmarks.\n");
+		exit(1);
+	}
+
+	memset(landmarks -> distance, 0xFF, cell_count * count * sizeof(uint16_t));
+
+	for (cell = 0; cell < cell_count; cell++) {
+
+		component_size[maze -> component[cell]]++;
+	}
+
+	largest = (maze -> component_count > 0) ? 1 : 0;
+	for (component = 2; component <= maze -> component_count; component++) {
+
+		largest = (component_size[component] > component_size[largest]) ? component : largest;
+	}
+
+	for (source = 0; source < cell_count && (largest == 0 || maze -> component[source] != largest); source++);
+	if (source == cell_count) {	// No free cell, no landmark.
+
+		free(distance);
+		free(nearest);
+		free(queue);
+		free(component_size);
+		return landmarks;
+	}
+
+	memset(nearest, 0xFF, cell_count * sizeof(uint32_t));
+	landmark_flood(maze, source, distance, queue);
+
+	while (landmarks -> count < count) {
+
+		// Next landmark: the reached cell farthest from every landmark so far (from 'source' for the first one).
+		for (cell = 0; cell < cell_count; cell++) {
+
+			if (distance[cell] != UINT32_MAX && (landmarks -> count <= 1 || distance[cell] < nearest[cell])) {
+
+				nearest[cell] = distance[cell];
+			}
+		}
+
+		for (cell = 0; cell < cell_count; cell++) {
+
+			if (nearest[cell] != UINT32_MAX && nearest[cell] > nearest[source]) {
+
+				source = cell;
+			}
+		}
+
+		if (nearest[source] == 0 && landmarks -> count > 0) {	// Every cell already is a landmark.
+
+			break;
+		}
+
+		i = landmarks -> count++;
+		landmarks -> cells[i].x = (int)(source / maze_size);
+		landmarks -> cells[i].y = (int)(source % maze_size);
+
+		landmark_flood(maze, source, distance, queue);
+		for (cell = 0; cell < cell_count; cell++) {
+
+			// Farther cells are capped one below LANDMARK_UNKNOWN, the bound stays consistent since the cap moves by at most 1 per move too.
+			if (distance[cell] == UINT32_MAX) {
+
+				landmarks -> distance[cell * count + i] = LANDMARK_UNKNOWN;
+			}
+			else {
+
+				landmarks -> distance[cell * count + i] = (distance[cell] < LANDMARK_UNKNOWN - 1) ? (uint16_t)distance[cell] : LANDMARK_UNKNOWN - 1;
+			}
+		}
+	}
+
+	// Rows of the table keep 'count' entries, even if fewer landmarks were found.
+	for (i = landmarks -> count; i < count; i++) {
+
+		landmarks -> cells[i] = landmarks -> cells[0];
+	}
+	landmarks -> count = count;
+
+	free(distance);
+	free(nearest);
+	free(queue);
+	free(component_size);
+
+	return landmarks;
+}
+
+void free_landmarks(landmarks_t *landmarks) {
+
+	free(landmarks -> cells);
+	free(landmarks -> distance);
+	free(landmarks);
+}
+
+void use_landmarks(goals_t *goals, landmarks_t *landmarks) {
+
+	/*	Makes goal_heuristic() use 'landmarks' for these exits (NULL goes back to the octile distance alone).
+		Keeps the closest and farthest exit from every landmark, so a bound costs the same for any number of exits.
+	*/
+	uint16_t distance;
+	int i, j;
+
+	free(goals -> landmark_min);
+	free(goals -> landmark_max);
+	goals -> landmarks = landmarks;
+	goals -> landmark_min = NULL;
+	goals -> landmark_max = NULL;
+
+	if (landmarks == NULL) {
+
+		return;
+	}
+
+	goals -> landmark_min = (int *)malloc(landmarks -> count * sizeof(int));
+	goals -> landmark_max = (int *)malloc(landmarks -> count * sizeof(int));
+	if (goals -> landmark_min == NULL || goals -> landmark_max == NULL) {
+
+		printf("Trouble allocating memory for landmark bounds.\n");
+		exit(1);
+	}
+
+	for (i = 0; i < landmarks -> count; i++) {
+
+		goals -> landmark_min[i] = LANDMARK_UNKNOWN;
+		goals -> landmark_max[i] = 0;
+
+		for (j = 0; j < goals -> count; j++) {
+
+			distance = landmarks -> distance[CELL_INDEX(goals -> cells[j], goals -> maze_size) * landmarks -> count + i];
+			if (distance == LANDMARK_UNKNOWN) {
+
+				// An exit this landmark knows nothing about could be the closest one, so the landmark is left out.
+				goals -> landmark_min[i] = goals -> landmark_max[i] = -1;
+				break;
+			}
+
+			goals -> landmark_min[i] = (distance < goals -> landmark_min[i]) ? distance : goals -> landmark_min[i];
+			goals -> landmark_max[i] = (distance > goals -> landmark_max[i]) ? distance : goals -> landmark_max[i];
+		}
+	}
+}
+
+// -----------------------------------
+// 		  Best First Search
+// -----------------------------------
+
+workspace_t *new_workspace(int frontier_type, int maze_size) {
+
+	workspace_t *new = NULL;
+	size_t cell_count = (size_t)maze_size * maze_size;
+
+	new = (workspace_t *)malloc(sizeof(workspace_t));
+	if (new == NULL) {
+
+		printf("Trouble allocating memory for search workspace.\n");
+		exit(1);
+	}
+
+	new -> maze_size = maze_size;
+	new -> frontier = new_frontier(frontier_type, maze_size);
+	new -> heap_frontier = NULL;
+	new -> visited = new_bitset(cell_count);
+	new -> parent = new_parents(cell_count);
+	new -> cost = (int *)malloc(cell_count * sizeof(int));
+	new -> touched = (size_t *)malloc(cell_count * sizeof(size_t));
+	if (new -> cost == NULL || new -> touched == NULL) {
+
+		printf("Trouble allocating memory for search workspace.\n");
+		exit(1);
+	}
+
+	new -> touched_count = 0;
+
+	return new;
+}
+
+void free_workspace(workspace_t *workspace) {
+
+	free_frontier(workspace -> frontier);
+	if (workspace -> heap_frontier != NULL) {
+
+		free_frontier(workspace -> heap_frontier);
+	}
+	free(workspace -> visited);
+	free(workspace -> parent);
+	free(workspace -> cost);
+	free(workspace -> touched);
+	free(workspace);
+}
+
+void reset_workspace(workspace_t *workspace) {	// Undo the previous search, in time proportional to the cells it reached.
+
+	size_t i, index;
+
+	for (i = 0; i < workspace -> touched_count; i++) {
+
+		index = workspace -> touched[i];
+		workspace -> visited[index >> 6] &= ~((uint64_t)1 << (index & 63));
+	}
+
+	workspace -> touched_count = 0;
+	clear_frontier(workspace -> frontier);
+	if (workspace -> heap_frontier != NULL) {
+
+		clear_frontier(workspace -> heap_frontier);
+	}
+}
+
+int search_frontier_type(int frontier_type, double weight) {	// The frontier a search at 'weight' runs on, given the workspace's.
+
+	// g(n) + w * h(n) spreads further than the bucket queue's 2 * maze_size buckets cover,
+	// so nodes of different priorities would share a bucket.
+	if (weight > 1 && frontier_type == FRONTIER_BUCKET_QUEUE) {
+
+		return FRONTIER_BINARY_HEAP;
+	}
+
+	return frontier_type;
+}
+
+int weighted_heuristic(coordinates_t cell, goals_t *goals, double weight) {	// w * h(n), rounded down so a weight of 1 gives h(n) exactly.
+
+	return (weight > 0) ? (int)(weight * goal_heuristic(cell, goals)) : 0;
+}
+
+typedef struct search_s {	// A best first search run a few expansions at a time, see search_begin().
+
+	workspace_t *workspace;	// Holds the frontier, closed set, parents and costs between steps.
+	frontier_t *frontier;	// The workspace's frontier, or its heap, see search_frontier_type().
+	maze_t *maze;
+	goals_t *goals;
+	coordinates_t S;
+	double weight;			// See weighted_best_first().
+	int done;				// 'result' is final.
+	search_result_t result;
+}search_t;
+
+void search_begin(search_t *search, workspace_t *workspace, maze_t *maze, coordinates_t S, goals_t *goals, double weight) {
+
+	/*	Start a search from S, without expanding anything yet: search_step() does the work.
+		The search owns 'workspace' until it is done, and only reads 'maze' and 'goals'.
+	*/
+	search_stats_t *stats = &(search -> result.stats);
+	long phase_start = now_ns();
+
+	search -> workspace = workspace;
+	search -> frontier = workspace -> frontier;
+	search -> maze = maze;
+	search -> goals = goals;
+	search -> S = S;
+	search -> weight = weight;
+	search -> done = 0;
+
+	memset(&(search -> result), 0, sizeof(search_result_t));
+
+	if (!can_reach(maze, S, goals)) {
+
+		set_unreachable(&(search -> result));
+		search -> done = 1;
+		return;
+	}
+
+	reset_workspace(workspace);
+
+	// The workspace's own frontier is left as it is, the next search may need it again.
+	if (search_frontier_type(workspace -> frontier -> type, weight) != workspace -> frontier -> type) {
+
+		if (workspace -> heap_frontier == NULL) {
+
+			workspace -> heap_frontier = new_frontier(FRONTIER_BINARY_HEAP, maze -> size);
+		}
+		search -> frontier = workspace -> heap_frontier;
+	}
+
+	workspace -> cost[CELL_INDEX(S, maze -> size)] = 0;
+	workspace -> touched[workspace -> touched_count++] = CELL_INDEX(S, maze -> size);
+	push(search -> frontier, S, weighted_heuristic(S, goals, weight));
+
+	stats -> setup_ns = now_ns() - phase_start;
+}
+
+int search_step(search_t *search, int max_expansions) {	// Expand at most 'max_expansions' cells (all of them if < 1). Returns 1 once the search is done.
+
+	workspace_t *workspace = search -> workspace;
+	frontier_t *search_frontier = search -> frontier;
+	uint64_t *visited = workspace -> visited;
+	unsigned char *parent = workspace -> parent;
+	int *cost = workspace -> cost;		// The g(n) value of each node reached so far, indexed by CELL_INDEX.
+	maze_t *maze = search -> maze;
+	goals_t *goals = search -> goals;
+	search_result_t *result = &(search -> result);
+	search_stats_t *stats = &(result -> stats);
+	coordinates_t current_coordinates, new_coordinates;
+	int maze_size = maze -> size;
+	int new_cost = 0, expansions = 0;
+	int move, goal = 0;
+	long phase_start = now_ns();
+
+	if (search -> done) {
+
+		return 1;
+	}
+
+	while (!is_empty(search_frontier)) {
+
+		if (max_expansions > 0 && expansions == max_expansions) {
+
+			stats -> search_ns += now_ns() - phase_start;
+			return 0;
+		}
+
+		// Pop before expanding, a neighbor pushed below may take the head's place.
+		current_coordinates = peek(search_frontier);
+		pop(search_frontier);
+
+		if (is_visited(current_coordinates, visited, maze_size)) {
+
+			stats -> stale_pops++;
+			continue;
+		}
+
+		goal = is_goal(current_coordinates, goals);
+		if (goal != 0) {
+
+			break;
+		}
+
+		// Apply Transition Operators for each node of the Search Frontier (clockwise).
+		for (move = 0; move < 8; move++) {
+
+			new_coordinates.x = current_coordinates.x + move_x[move];
+			new_coordinates.y = current_coordinates.y + move_y[move];
+
+			if (!in_maze(new_coordinates, maze_size) || maze_cell(maze, new_coordinates.x, new_coordinates.y) == 0 || is_visited(new_coordinates, visited, maze_size)) {
+
+				continue;
+			}
+
+			new_cost = cost[CELL_INDEX(current_coordinates, maze_size)] + 1;
+
+			if (!check_frontier(search_frontier, new_coordinates)) {
+
+				cost[CELL_INDEX(new_coordinates, maze_size)] = new_cost;
+				set_parent(parent, CELL_INDEX(new_coordinates, maze_size), move);
+				workspace -> touched[workspace -> touched_count++] = CELL_INDEX(new_coordinates, maze_size);
+				push(search_frontier, new_coordinates, weighted_heuristic(new_coordinates, goals, search -> weight) + new_cost);
+				result -> expansion_count++;
+			}
+			else if (new_cost < cost[CELL_INDEX(new_coordinates, maze_size)]) {
+
+				// A better route to a node already in the frontier, update it in place.
+				cost[CELL_INDEX(new_coordinates, maze_size)] = new_cost;
+				set_parent(parent, CELL_INDEX(new_coordinates, maze_size), move);
+				decrease_key(search_frontier, new_coordinates, weighted_heuristic(new_coordinates, goals, search -> weight) + new_cost);
+			}
+		}
+
+		push_visited(current_coordinates, visited, maze_size);
+		stats -> closed_count++;
+		expansions++;
+	}
+
+	result -> goal = goal;
+	result -> goal_cell = (goal != 0) ? current_coordinates : search -> S;
+	result -> path_cost = (goal != 0) ? cost[CELL_INDEX(current_coordinates, maze_size)] : -1;
+	result -> node_reuses = frontier_node_reuses(search_frontier);
+
+	stats -> search_ns += now_ns() - phase_start;
+	collect_frontier_stats(search_frontier, stats);
+	stats -> bytes_allocated += search_memory_bytes((size_t)maze_size * maze_size) + (size_t)maze_size * maze_size * sizeof(size_t);
+
+	search -> done = 1;
+	return 1;
+}
+
+search_result_t *search_result(search_t *search) {	// NULL until search_step() has returned 1. The route's parents are in the workspace.
+
+	return search -> done ? &(search -> result) : NULL;
+}
+
+void weighted_best_first(workspace_t *workspace, maze_t *maze, coordinates_t S, goals_t *goals, double weight, search_result_t *result) {
+
+	/*	The search shared by ucs() (weight = 0, f(n) = g(n)) and a_star() (f(n) = g(n) + w * h(n)), run to the end in one call.
+		With w > 1 the heuristic is inflated: far fewer cells are expanded, and the route costs at most w times the optimal one.
+		Leaves the route's parent moves and costs in 'workspace' for reconstruct_path(), and only reads 'maze'
+		and 'goals', so any number of workspaces can search the same maze at once.
+	*/
+	search_t search;
+
+	search_begin(&search, workspace, maze, S, goals, weight);
+	search_step(&search, 0);
+
+	*result = search.result;
+}
+
+void best_first(workspace_t *workspace, maze_t *maze, coordinates_t S, goals_t *goals, int use_heuristic, search_result_t *result) {	// Optimal: UCS, or A* when 'use_heuristic'.
+
+	weighted_best_first(workspace, maze, S, goals, use_heuristic ? 1.0 : 0.0, result);
+}
+
+void print_search_result(workspace_t *workspace, coordinates_t S, goals_t *goals, search_result_t *result) {
+
+	coordinates_t *path = NULL;
+	long phase_start = now_ns();
+
+	if (result -> goal == 0) {
+
+		print_unreachable(goals);
+	}
+	else {
+
+		printf("Reached G%d[%d][%d].\n", result -> goal, result -> goal_cell.x, result -> goal_cell.y);
+
+		path = reconstruct_path(workspace -> parent, workspace -> maze_size, S, result -> goal_cell, result -> path_cost);
+		print_path(path, result -> path_cost + 1);
+		printf("Number of expansions: %d.\n", result -> expansion_count);
+		printf("Frontier nodes reused: %ld.\n", result -> node_reuses);
+
+		free(path);
+	}
+
+	result -> stats.output_ns = now_ns() - phase_start;
+	if (show_stats) {
+
+		print_search_stats(&(result -> stats));
+	}
+}
+
+// -----------------------------------
+// 		  Uniform Cost Search
+// -----------------------------------
+
+void ucs(maze_t *maze, coordinates_t S, goals_t *goals, int frontier_type) {
+
+	long setup_start = now_ns();
+	workspace_t *workspace = new_workspace(frontier_type, maze -> size);
+	search_result_t result;
+	long setup_ns = now_ns() - setup_start;
+
+	best_first(workspace, maze, S, goals, 0, &result);
+	result.stats.setup_ns += setup_ns;
+	print_search_result(workspace, S, goals, &result);
+
+	free_workspace(workspace);
+}
+
+// -----------------------------------
+// 			Anytime Search
+// -----------------------------------
+
+/*	ARA* (Anytime Repairing A*): a weighted A* with a large weight finds a first route quickly, then the
+	weight is lowered step by step and each search reuses the costs of the previous ones instead of starting over.
+	Cells reached more cheaply after they were expanded wait in INCONS and rejoin the frontier when the weight drops.
+	After every search the route is proven to cost at most
+		min(w, g(exit) / min of g(n) + h(n) over the frontier and INCONS)
+	times the optimal cost, a bound of 1 meaning it is optimal.
+*/
+#define ARA_INITIAL_WEIGHT 3.0
+#define ARA_WEIGHT_STEP 0.5		// Taken off the weight after every search, down to 1.
+#define ARA_BUDGET_MS 100		// Time given to the anytime search in main().
+#define ARA_DEADLINE_CHECK 256	// Expansions between two looks at the clock.
+#define ARA_NO_ROUTE INT32_MAX
+
+typedef struct ara_s {
+
+	maze_t *maze;
+	goals_t *goals;
+	coordinates_t S;
+	workspace_t *workspace;	// Heap frontier (OPEN), visited (CLOSED), parent moves and g(n) of the reached cells.
+	uint64_t *reached;		// Cells with a g(n).
+	uint64_t *inconsistent;	// Cells in INCONS.
+	size_t *incons;
+	size_t incons_count;
+	coordinates_t *open;	// Room for every cell, to re-key the frontier when the weight drops.
+	double weight;
+	double weight_step;
+	int interrupted;		// The last search stopped at its deadline and resumes on the next ara_search().
+	int searches;			// Searches completed.
+	int goal;				// Exit of the best route so far (1 for G1), 0 if none yet.
+	coordinates_t goal_cell;
+	int goal_cost;			// g(n) of that exit, ARA_NO_ROUTE if none yet.
+	double bound;			// Proven suboptimality of the best route, 0 if none or unknown yet.
+	long expansion_count;	// Over every search.
+}ara_t;
+
+ara_t *new_ara(maze_t *maze, coordinates_t S, goals_t *goals, double weight, double weight_step) {
+
+	ara_t *new = NULL;
+	size_t cell_count = (size_t)maze -> size * maze -> size;
+	size_t index = CELL_INDEX(S, maze -> size);
+
+	new = (ara_t *)malloc(sizeof(ara_t));
+	if (new == NULL) {
+
+		printf("[ARA*] Trouble allocating memory for the search.\n");
+		exit(1);
+	}
+
+	new -> maze = maze;
+	new -> goals = goals;
+	new -> S = S;
+	new -> workspace = new_workspace(FRONTIER_BINARY_HEAP, maze -> size);	// Priorities go down when the weight does.
+	new -> reached = new_bitset(cell_count);
+	new -> inconsistent = new_bitset(cell_count);
+	new -> incons = (size_t *)malloc(cell_count * sizeof(size_t));
+	new -> open = (coordinates_t *)malloc(cell_count * sizeof(coordinates_t));
+	if (new -> incons == NULL || new -> open == NULL) {
+
+		printf("[ARA*] Trouble allocating memory for the search.\n");
+		exit(1);
+	}
+
+	new -> incons_count = 0;
+	new -> weight = (weight > 1) ? weight : 1;
+	new -> weight_step = (weight_step > 0) ? weight_step : ARA_WEIGHT_STEP;
+	new -> interrupted = 0;
+	new -> searches = 0;
+	new -> goal = 0;
+	new -> goal_cell = S;
+	new -> goal_cost = ARA_NO_ROUTE;
+	new -> bound = 0;
+	new -> expansion_count = 0;
+
+	// Left with an empty frontier, the first search ends at once and reports no route.
+	if (!can_reach(maze, S, goals)) {
+
+		return new;
+	}
+
+	new -> workspace -> cost[index] = 0;
+	new -> workspace -> touched[new -> workspace -> touched_count++] = index;
+	push_visited(S, new -> reached, maze -> size);
+	push(new -> workspace -> frontier, S, weighted_heuristic(S, goals, new -> weight));
+
+	new -> goal = is_goal(S, goals);
+	if (new -> goal != 0) {
+
+		new -> goal_cost = 0;
+	}
+
+	return new;
+}
+
+void free_ara(ara_t *ara) {	// The maze and the exits belong to the caller.
+
+	free_workspace(ara -> workspace);
+	free(ara -> reached);
+	free(ara -> inconsistent);
+	free(ara -> incons);
+	free(ara -> open);
+	free(ara);
+}
+
+int ara_improve(ara_t *ara, long deadline_ns) {	// Expand until no cell can lead to a cheaper route at this weight. 0 if the deadline came first.
+
+	workspace_t *workspace = ara -> workspace;
+	frontier_t *search_frontier = workspace -> frontier;
+	int maze_size = ara -> maze -> size;
+	coordinates_t current_coordinates, new_coordinates;
+	size_t index;
+	int move, goal, new_cost;
+	long expansion_count = 0;
+
+	while (!is_empty(search_frontier) && ara -> goal_cost > frontier_priority(search_frontier, peek(search_frontier))) {
+
+		if (expansion_count++ % ARA_DEADLINE_CHECK == 0 && now_ns() >= deadline_ns) {
+
+			return 0;
+		}
+
+		current_coordinates = peek(search_frontier);
+		pop(search_frontier);
+		push_visited(current_coordinates, workspace -> visited, maze_size);
+		ara -> expansion_count++;
+
+		for (move = 0; move < 8; move++) {
+
+			new_coordinates.x = current_coordinates.x + move_x[move];
+			new_coordinates.y = current_coordinates.y + move_y[move];
+
+			if (!in_maze(new_coordinates, maze_size) || maze_cell(ara -> maze, new_coordinates.x, new_coordinates.y) == 0) {
+
+				continue;
+			}
+
+			index = CELL_INDEX(new_coordinates, maze_size);
+			new_cost = workspace -> cost[CELL_INDEX(current_coordinates, maze_size)] + 1;
+
+			if (is_visited(new_coordinates, ara -> reached, maze_size)) {
+
+				if (new_cost >= workspace -> cost[index]) {
+
+					continue;
+				}
+			}
+			else {
+
+				push_visited(new_coordinates, ara -> reached, maze_size);
+				workspace -> touched[workspace -> touched_count++] = index;
+			}
+
+			workspace -> cost[index] = new_cost;
+			set_parent(workspace -> parent, index, move);
+
+			goal = is_goal(new_coordinates, ara -> goals);
+			if (goal != 0 && new_cost < ara -> goal_cost) {
+
+				ara -> goal = goal;
+				ara -> goal_cell = new_coordinates;
+				ara -> goal_cost = new_cost;
+			}
+
+			if (is_visited(new_coordinates, workspace -> visited, maze_size)) {
+
+				// Already expanded at this weight, it waits for the next one.
+				if (!is_visited(new_coordinates, ara -> inconsistent, maze_size)) {
+
+					push_visited(new_coordinates, ara -> inconsistent, maze_size);
+					ara -> incons[ara -> incons_count++] = index;
+				}
+			}
+			else if (check_frontier(search_frontier, new_coordinates)) {
+
+				decrease_key(search_frontier, new_coordinates, new_cost + weighted_heuristic(new_coordinates, ara -> goals, ara -> weight));
+			}
+			else {
+
+				push(search_frontier, new_coordinates, new_cost + weighted_heuristic(new_coordinates, ara -> goals, ara -> weight));
+			}
+		}
+	}
+
+	return 1;
+}
+
+double ara_bound(ara_t *ara) {	// Suboptimality of the best route, proven by the cells that could still lead to a cheaper one. 0 if unknown.
+
+	int *cost = ara -> workspace -> cost;
+	int maze_size = ara -> maze -> size;
+	int i, count, f, min_f = ARA_NO_ROUTE;
+	size_t j;
+	coordinates_t cell;
+	double bound;
+
+	if (ara -> goal == 0) {
+
+		return 0;
+	}
+
+	count = frontier_cells(ara -> workspace -> frontier, ara -> open);
+	for (i = 0; i < count; i++) {
+
+		f = cost[CELL_INDEX(ara -> open[i], maze_size)] + goal_heuristic(ara -> open[i], ara -> goals);
+		min_f = (f < min_f) ? f : min_f;
+	}
+
+	for (j = 0; j < ara -> incons_count; j++) {
+
+		cell.x = ara -> incons[j] / maze_size;
+		cell.y = ara -> incons[j] % maze_size;
+		f = cost[ara -> incons[j]] + goal_heuristic(cell, ara -> goals);
+		min_f = (f < min_f) ? f : min_f;
+	}
+
+	if (ara -> goal_cost <= min_f) {
+
+		return 1;
+	}
+
+	// A completed search also bounds the route by its weight, and earlier bounds still hold for a route that only got cheaper.
+	bound = (min_f > 0) ? (double)ara -> goal_cost / min_f : 0;
+	if (!ara -> interrupted && (bound == 0 || bound > ara -> weight)) {
+
+		bound = ara -> weight;
+	}
+
+	if (ara -> bound > 0 && (bound == 0 || bound > ara -> bound)) {
+
+		bound = ara -> bound;
+	}
+
+	return bound;
+}
+
+int ara_done(ara_t *ara) {	// Nothing left to improve: the route is optimal or there is none.
+
+	return ara -> searches > 0 && !ara -> interrupted && (ara -> goal == 0 || ara -> bound <= 1);
+}
+
+int ara_search(ara_t *ara, long deadline_ns) {
+
+	/*	Run the next search of the sequence, or resume the one the last deadline interrupted.
+		Returns 1 once it completes, with the route and ara -> bound updated, and 0 if 'deadline_ns'
+		(see now_ns()) came first or ara_done() already holds.
+	*/
+	workspace_t *workspace = ara -> workspace;
+	frontier_t *search_frontier = workspace -> frontier;
+	int maze_size = ara -> maze -> size;
+	coordinates_t cell;
+	int i, count;
+	size_t j;
+
+	if (ara_done(ara)) {
+
+		return 0;
+	}
+
+	if (ara -> searches > 0 && !ara -> interrupted) {
+
+		ara -> weight = (ara -> weight - ara -> weight_step > 1) ? ara -> weight - ara -> weight_step : 1;
+
+		// OPEN = OPEN + INCONS keyed with the new weight, and CLOSED starts over.
+		count = frontier_cells(search_frontier, ara -> open);
+		for (j = 0; j < ara -> incons_count; j++) {
+
+			cell.x = ara -> incons[j] / maze_size;
+			cell.y = ara -> incons[j] % maze_size;
+			ara -> inconsistent[ara -> incons[j] >> 6] &= ~((uint64_t)1 << (ara -> incons[j] & 63));
+			if (!check_frontier(search_frontier, cell)) {
+
+				ara -> open[count++] = cell;
+			}
+		}
+
+		ara -> incons_count = 0;
+		clear_frontier(search_frontier);
+		for (i = 0; i < count; i++) {
+
+			push(search_frontier, ara -> open[i], workspace -> cost[CELL_INDEX(ara -> open[i], maze_size)] + weighted_heuristic(ara -> open[i], ara -> goals, ara -> weight));
+		}
+
+		for (j = 0; j < workspace -> touched_count; j++) {
+
+			workspace -> visited[workspace -> touched[j] >> 6] &= ~((uint64_t)1 << (workspace -> touched[j] & 63));
+		}
+	}
+
+	ara -> interrupted = !ara_improve(ara, deadline_ns);
+	ara -> bound = ara_bound(ara);
+	if (ara -> interrupted) {
+
+		return 0;
+	}
+
+	ara -> searches++;
+
+	return 1;
+}
+
+coordinates_t *ara_path(ara_t *ara, int *path_cost) {	// Best route so far, NULL if none. Parent moves only lead to cheaper cells, so the walk ends at S.
+
+	coordinates_t *path = NULL;
+	coordinates_t cell = ara -> goal_cell;
+	int maze_size = ara -> maze -> size;
+	int i, move, count = 0;
+
+	if (ara -> goal == 0) {
+
+		*path_cost = -1;
+		return NULL;
+	}
+
+	while (cell.x != ara -> S.x || cell.y != ara -> S.y) {
+
+		move = get_parent(ara -> workspace -> parent, CELL_INDEX(cell, maze_size));
+		cell.x -= move_x[move];
+		cell.y -= move_y[move];
+		count++;
+	}
+
+	path = (coordinates_t *)malloc((count + 1) * sizeof(coordinates_t));
+	if (path == NULL) {
+
+		printf("[ARA*] Trouble allocating memory for the path.\n");
+		exit(1);
+	}
+
+	cell = ara -> goal_cell;
+	for (i = count; i > 0; i--) {
+
+		path[i] = cell;
+		move = get_parent(ara -> workspace -> parent, CELL_INDEX(cell, maze_size));
+		cell.x -= move_x[move];
+		cell.y -= move_y[move];
+	}
+	path[0] = ara -> S;
+
+	*path_cost = count;
+	return path;
+}
+
+coordinates_t *ara_star_search(maze_t *maze, coordinates_t S, goals_t *goals, double weight, long deadline_ns, search_result_t *result, double *bound) {	// Non-printing anytime_a_star(), 'bound' may be NULL.
+
+	ara_t *ara = new_ara(maze, S, goals, weight, ARA_WEIGHT_STEP);
+	coordinates_t *path = NULL;
+
+	memset(&(result -> stats), 0, sizeof(search_stats_t));
+	while (ara_search(ara, deadline_ns));
+
+	path = ara_path(ara, &(result -> path_cost));
+	result -> goal = ara -> goal;
+	result -> goal_cell = ara -> goal_cell;
+	result -> expansion_count = (int)ara -> expansion_count;
+	result -> node_reuses = 0;
+	result -> stats.closed_count = ara -> expansion_count;
+	if (bound != NULL) {
+
+		*bound = ara -> bound;
+	}
+
+	free_ara(ara);
+	return path;
+}
+
+void anytime_a_star(maze_t *maze, coordinates_t S, goals_t *goals, double weight, long budget_ms) {	// ARA* from 'weight', printing every improvement until the route is optimal or 'budget_ms' runs out.
+
+	long start = now_ns();
+	long deadline_ns = start + budget_ms * 1000000;
+	ara_t *ara = new_ara(maze, S, goals, weight, ARA_WEIGHT_STEP);
+	coordinates_t *path = NULL;
+	int path_cost;
+
+	while (ara_search(ara, deadline_ns)) {
+
+		if (ara -> goal != 0) {
+
+			printf("w = %.2f: route of cost %d, within %.3f of the optimal one, %ld expansions, %.3f ms.\n", ara -> weight, ara -> goal_cost, ara -> bound, ara -> expansion_count, (now_ns() - start) / 1e6);
+		}
+	}
+
+	if (ara -> goal == 0) {
+
+		if (ara -> searches > 0) {
+
+			print_unreachable(goals);
+		}
+		else {
+
+			printf("No route found within %ld ms.\n", budget_ms);
+		}
+	}
+	else {
+
+		printf("Reached G%d[%d][%d].\n", ara -> goal, ara -> goal_cell.x, ara -> goal_cell.y);
+
+		path = ara_path(ara, &path_cost);
+		print_path(path, path_cost + 1);
+		printf("Number of expansions: %ld.\n", ara -> expansion_count);
+		if (ara -> bound > 0) {
+
+			printf("Suboptimality bound: %.3f%s.\n", ara -> bound, ara_done(ara) ? "" : " (deadline reached)");
+		}
+		else {
+
+			printf("Suboptimality bound: unknown (deadline reached).\n");
+		}
+
+		free(path);
+	}
+
+	free_ara(ara);
+}
+
+// -----------------------------------
+// 				  A*
+// -----------------------------------
+
+void a_star(maze_t *maze, coordinates_t S, goals_t *goals, int frontier_type, landmarks_t *landmarks, double weight, long budget_ms) {
+
+	/*	'landmarks' adds the ALT bound to h(n), NULL for the octile distance only.
+		'weight' inflates h(n): 1 for an optimal route, more for a faster one costing at most 'weight' times as much.
+		A 'budget_ms' above 0 runs anytime_a_star() from 'weight' instead, improving the route until the time is up.
+	*/
+	long setup_start = now_ns();
+	workspace_t *workspace = NULL;
+	search_result_t result;
+	long setup_ns;
+
+	if (landmarks != NULL) {
+
+		use_landmarks(goals, landmarks);
+	}
+
+	if (budget_ms > 0) {
+
+		anytime_a_star(maze, S, goals, weight, budget_ms);
+	}
+	else {
+
+		workspace = new_workspace(frontier_type, maze -> size);
+		setup_ns = now_ns() - setup_start;
+
+		weighted_best_first(workspace, maze, S, goals, weight, &result);
+		result.stats.setup_ns += setup_ns;
+		print_search_result(workspace, S, goals, &result);
+
+		if (weight > 1 && result.goal != 0) {
+
+			printf("Suboptimality bound: %.2f.\n", weight);
+		}
+
+		free_workspace(workspace);
+	}
+
+	if (landmarks != NULL) {
+
+		use_landmarks(goals, NULL);
+	}
+}
+
+// -----------------------------------
+// 		  Jump Point Search
+// -----------------------------------
+
+// Every move costs 1 here, diagonal or not, so a jump of n cells costs n and
+// JPS ranks nodes with the same g(n) and h(n) as a_star(). The pruning rules
+// keep, for every route, one of the same number of steps that goes diagonal
+// first and turns only at jump points, so routes stay as short as UCS's.
+
+int walkable(maze_t *maze, int x, int y) {
+
+	return x >= 0 && x < maze -> size && y >= 0 && y < maze -> size && maze_cell(maze, x, y) == 1;
+}
+
+int move_code(int dx, int dy) {		// Index of (dx, dy) in move_x/move_y.
+
+	int move;
+
+	for (move = 0; move < 8; move++) {
+
+		if (move_x[move] == dx && move_y[move] == dy) {
+
+			return move;
+		}
+	}
+
+	return -1;
+}
+
+int jump(maze_t *maze, coordinates_t from, int dx, int dy, goals_t *goals, coordinates_t *jump_point) {
+
+	/*	Walks from 'from' towards (dx, dy) until it finds a jump point: a goal, a node with a forced
+		neighbor, or (moving diagonally) a node from which a straight jump finds one. Returns 0 when
+		the walk runs into a wall or the maze edge first.
+	*/
+	coordinates_t current = from, unused;
+
+	while (1) {
+
+		current.x += dx;
+		current.y += dy;
+
+		if (!walkable(maze, current.x, current.y)) {
+
+			return 0;
+		}
+
+		if (is_goal(current, goals)) {
+
+			break;
+		}
+
+		if (dx != 0 && dy != 0) {		// Diagonal.
+
+			if ((walkable(maze, current.x - dx, current.y + dy) && !walkable(maze, current.x - dx, current.y)) ||
+				(walkable(maze, current.x + dx, current.y - dy) && !walkable(maze, current.x, current.y - dy))) {
+
+				break;
+			}
+
+			if (jump(maze, current, dx, 0, goals, &unused) || jump(maze, current, 0, dy, goals, &unused)) {
+
+				break;
+			}
+		}
+		else if (dx != 0) {				// Up or down.
+
+			if ((walkable(maze, current.x + dx, current.y + 1) && !walkable(maze, current.x, current.y + 1)) ||
+				(walkable(maze, current.x + dx, current.y - 1) && !walkable(maze, current.x, current.y - 1))) {
+
+				break;
+			}
+		}
+		else {							// Left or right.
+
+			if ((walkable(maze, current.x + 1, current.y + dy) && !walkable(maze, current.x + 1, current.y)) ||
+				(walkable(maze, current.x - 1, current.y + dy) && !walkable(maze, current.x - 1, current.y))) {
+
+				break;
+			}
+		}
+	}
+
+	*jump_point = current;
+	return 1;
+}
+
+int jps_directions(maze_t *maze, coordinates_t cell, int arrival, int *directions) {
+
+	/*	Fills 'directions' with the moves worth jumping in from 'cell' when it was reached through move
+		'arrival' (-1 for the starting cell): the natural neighbors plus the forced ones. Returns their count.
+	*/
+	int dx, dy, count = 0, move;
+
+	if (arrival < 0) {
+
+		for (move = 0; move < 8; move++) {
+
+			directions[count++] = move;
+		}
+
+		return count;
+	}
+
+	dx = move_x[arrival];
+	dy = move_y[arrival];
+
+	directions[count++] = arrival;
+
+	if (dx != 0 && dy != 0) {
+
+		directions[count++] = move_code(dx, 0);
+		directions[count++] = move_code(0, dy);
+
+		if (!walkable(maze, cell.x - dx, cell.y) && walkable(maze, cell.x - dx, cell.y + dy)) {
+
+			directions[count++] = move_code(-dx, dy);
+		}
+
+		if (!walkable(maze, cell.x, cell.y - dy) && walkable(maze, cell.x + dx, cell.y - dy)) {
+
+			directions[count++] = move_code(dx, -dy);
+		}
+	}
+	else if (dx != 0) {
+
+		if (!walkable(maze, cell.x, cell.y + 1) && walkable(maze, cell.x + dx, cell.y + 1)) {
+
+			directions[count++] = move_code(dx, 1);
+		}
+
+		if (!walkable(maze, cell.x, cell.y - 1) && walkable(maze, cell.x + dx, cell.y - 1)) {
+
+			directions[count++] = move_code(dx, -1);
+		}
+	}
+	else {
+
+		if (!walkable(maze, cell.x + 1, cell.y) && walkable(maze, cell.x + 1, cell.y + dy)) {
+
+			directions[count++] = move_code(1, dy);
+		}
+
+		if (!walkable(maze, cell.x - 1, cell.y) && walkable(maze, cell.x - 1, cell.y + dy)) {
+
+			directions[count++] = move_code(-1, dy);
+		}
+	}
+
+	return count;
+}
+
+coordinates_t *jps_reconstruct_path(maze_t *maze, unsigned char *parent, int *cost, uint64_t *visited, coordinates_t S, coordinates_t goal, int *path_count) {
+
+	/*	Only jump points have a parent move, so walk back along it one cell at a time until an expanded
+		jump point whose cost accounts for the steps taken (the jump's origin, or an equally cheap one).
+	*/
+	coordinates_t *path = NULL, *new_path = NULL;
+	coordinates_t current = goal, previous;
+	int capacity = 64, count = 0, move, steps, i;
+	int maze_size = maze -> size;
+
+	path = (coordinates_t *)malloc(capacity * sizeof(coordinates_t));
+	if (path == NULL) {
+
+		printf("[JPS] Trouble allocating memory for 'path' array.\n");
+		exit(1);
+	}
+
+	path[count++] = current;
+
+	while (current.x != S.x || current.y != S.y) {
+
+		move = get_parent(parent, CELL_INDEX(current, maze_size));
+		previous = current;
+
+		for (steps = 1; ; steps++) {
+
+			previous.x -= move_x[move];
+			previous.y -= move_y[move];
+
+			if (count == capacity) {
+
+				capacity *= 2;
+				new_path = (coordinates_t *)realloc(path, capacity * sizeof(coordinates_t));
+				if (new_path == NULL) {
+
+					printf("[JPS] Trouble reallocating memory for 'path' array.\n");
+					exit(1);
+				}
+				path = new_path;
+			}
+			path[count++] = previous;
+
+			if (is_visited(previous, visited, maze_size) && cost[CELL_INDEX(previous, maze_size)] + steps == cost[CELL_INDEX(current, maze_size)]) {
+
+				break;
+			}
+		}
+
+		current = previous;
+	}
+
+	// Collected from the goal backwards.
+	for (i = 0; i < count / 2; i++) {
+
+		previous = path[i];
+		path[i] = path[count - 1 - i];
+		path[count - 1 - i] = previous;
+	}
+
+	*path_count = count;
+	return path;
+}
+
+coordinates_t *jps_search(maze_t *maze, coordinates_t S, goals_t *goals, int frontier_type, search_result_t *result) {
+
+	/*	Returns the route, every cell of it and not just the jump points, or NULL if no exit can be reached.
+		result -> path_cost counts steps on the grid, like the other searches.
+	*/
+	frontier_t *search_frontier = NULL;
+	uint64_t *visited = NULL;
+	unsigned char *parent = NULL;		// Move of the jump that reached each jump point.
+	coordinates_t *path = NULL;
+	int *cost = NULL;		// g(n) of each jump point, indexed by CELL_INDEX.
+	coordinates_t current_coordinates, new_coordinates;
+	int directions[8];
+	int maze_size = maze -> size;
+	int new_cost = 0, expansion_count = 0, path_count = 0;
+	int i, direction_count, move, steps, goal = 0;
+	search_stats_t *stats = &(result -> stats);
+	long phase_start = now_ns();
+
+	memset(stats, 0, sizeof(search_stats_t));
+
+	if (!can_reach(maze, S, goals)) {
+
+		set_unreachable(result);
+		return NULL;
+	}
+
+	visited = new_bitset((size_t)maze_size * maze_size);
+	parent = new_parents((size_t)maze_size * maze_size);
+
+	cost = (int *)malloc((size_t)maze_size * maze_size * sizeof(int));
+	if (cost == NULL) {
+
+		printf("[JPS] Trouble allocating memory for 'cost' array.\n");
+		exit(1);
+	}
+
+	cost[CELL_INDEX(S, maze_size)] = 0;
+
+	search_frontier = new_frontier(frontier_type, maze_size);
+	push(search_frontier, S, goal_heuristic(S, goals));
+
+	stats -> setup_ns = now_ns() - phase_start;
+	phase_start = now_ns();
+
+	while (!is_empty(search_frontier)) {
+
+		current_coordinates = peek(search_frontier);
+		pop(search_frontier);
+
+		if (is_visited(current_coordinates, visited, maze_size)) {
+
+			stats -> stale_pops++;
+			continue;
+		}
+
+		goal = is_goal(current_coordinates, goals);
+		if (goal != 0) {
+
+			break;
+		}
+
+		push_visited(current_coordinates, visited, maze_size);
+		stats -> closed_count++;
+
+		if (current_coordinates.x == S.x && current_coordinates.y == S.y) {
+
+			direction_count = jps_directions(maze, current_coordinates, -1, directions);
+		}
+		else {
+
+			direction_count = jps_directions(maze, current_coordinates, get_parent(parent, CELL_INDEX(current_coordinates, maze_size)), directions);
+		}
+
+		for (i = 0; i < direction_count; i++) {
+
+			move = directions[i];
+			if (!jump(maze, current_coordinates, move_x[move], move_y[move], goals, &new_coordinates) || is_visited(new_coordinates, visited, maze_size)) {
+
+				continue;
+			}
+
+			steps = abs(new_coordinates.x - current_coordinates.x);
+			if (abs(new_coordinates.y - current_coordinates.y) > steps) {
+
+				steps = abs(new_coordinates.y - current_coordinates.y);
+			}
+
+			new_cost = cost[CELL_INDEX(current_coordinates, maze_size)] + steps;
+
+			if (!check_frontier(search_frontier, new_coordinates)) {
+
+				cost[CELL_INDEX(new_coordinates, maze_size)] = new_cost;
+				set_parent(parent, CELL_INDEX(new_coordinates, maze_size), move);
+				push(search_frontier, new_coordinates, goal_heuristic(new_coordinates, goals) + new_cost);
+				expansion_count++;
+			}
+			else if (new_cost < cost[CELL_INDEX(new_coordinates, maze_size)]) {
+
+				cost[CELL_INDEX(new_coordinates, maze_size)] = new_cost;
+				set_parent(parent, CELL_INDEX(new_coordinates, maze_size), move);
+				decrease_key(search_frontier, new_coordinates, goal_heuristic(new_coordinates, goals) + new_cost);
+			}
+		}
+	}
+
+	stats -> search_ns = now_ns() - phase_start;
+	phase_start = now_ns();
+
+	if (goal != 0) {
+
+		path = jps_reconstruct_path(maze, parent, cost, visited, S, current_coordinates, &path_count);
+	}
+
+	result -> goal = goal;
+	result -> goal_cell = current_coordinates;
+	result -> path_cost = path_count - 1;
+	result -> expansion_count = expansion_count;
+	result -> node_reuses = frontier_node_reuses(search_frontier);
+
+	stats -> output_ns = now_ns() - phase_start;
+	collect_frontier_stats(search_frontier, stats);
+	stats -> bytes_allocated += search_memory_bytes((size_t)maze_size * maze_size);
+
+	free_frontier(search_frontier);
+	free(visited);
+	free(parent);
+	free(cost);
+
+	return path;
+}
+
+void jps(maze_t *maze, coordinates_t S, goals_t *goals, int frontier_type) {
+
+	search_result_t result;
+	coordinates_t *path = jps_search(maze, S, goals, frontier_type, &result);
+	long phase_start = now_ns();
+
+	if (path == NULL) {
+
+		print_unreachable(goals);
+	}
+	else {
+
+		printf("Reached G%d[%d][%d].\n", result.goal, result.goal_cell.x, result.goal_cell.y);
+
+		print_path(path, result.path_cost + 1);
+		printf("Number of expansions: %d.\n", result.expansion_count);
+		printf("Frontier nodes reused: %ld.\n", result.node_reuses);
+
+		free(path);
+	}
+
+	result.stats.output_ns += now_ns() - phase_start;
+	if (show_stats) {
+
+		print_search_stats(&(result.stats));
+	}
+}
+
+// -----------------------------------
+// 		 Bidirectional Search
+// -----------------------------------
+
+int reached(frontier_t *search_frontier, uint64_t *visited, coordinates_t cell, int maze_size) {	// Has this side of the search got a g(n) for 'cell'?
+
+	return check_frontier(search_frontier, cell) || is_visited(cell, visited, maze_size);
+}
+
+coordinates_t *bidirectional_search(maze_t *maze, coordinates_t S, goals_t *goals, int frontier_type, search_result_t *result, coordinates_t *meeting) {
+
+	/*	Two uniform cost searches, one forward from S and one backward from both goals at once,
+		always advancing the side with the smaller frontier. Every time a side reaches a cell the
+		other side has reached too, the route through it is a candidate of cost 'best_cost'.
+		Once the two frontier heads add up to at least 'best_cost', no undiscovered route can be cheaper.
+		Returns the route, or NULL if no exit can be reached, and the cell where the two sides met in 'meeting'.
+	*/
+	frontier_t *search_frontier[2] = {NULL, NULL};		// [0] forward from S, [1] backward from every exit.
+	uint64_t *visited[2] = {NULL, NULL};
+	unsigned char *parent[2] = {NULL, NULL};
+	int *cost[2] = {NULL, NULL};
+	coordinates_t *path = NULL;
+	coordinates_t current_coordinates, new_coordinates, meeting_cell = S, goal_cell;
+	int maze_size = maze -> size;
+	int new_cost = 0, expansion_count = 0, best_cost = -1;
+	int side, other, move, i;
+
+	search_stats_t *stats = &(result -> stats);
+	long phase_start = now_ns();
+
+	if (!can_reach(maze, S, goals)) {
+
+		set_unreachable(result);
+		*meeting = S;
+		return NULL;
+	}
+
+	result -> goal = 0;
+	memset(stats, 0, sizeof(search_stats_t));
+
+	for (side = 0; side < 2; side++) {
+
+		search_frontier[side] = new_frontier(frontier_type, maze_size);
+		visited[side] = new_bitset((size_t)maze_size * maze_size);
+		parent[side] = new_parents((size_t)maze_size * maze_size);
+
+		cost[side] = (int *)malloc((size_t)maze_size * maze_size * sizeof(int));
+		if (cost[side] == NULL) {
+
+			printf("[Bidirectional] Trouble allocating memory for 'cost' array.\n");
+			exit(1);
+		}
+	}
+
+	cost[0][CELL_INDEX(S, maze_size)] = 0;
+	push(search_frontier[0], S, 0);
+
+	for (i = 0; i < goals -> count; i++) {
+
+		if (!check_frontier(search_frontier[1], goals -> cells[i])) {
+
+			cost[1][CELL_INDEX(goals -> cells[i], maze_size)] = 0;
+			push(search_frontier[1], goals -> cells[i], 0);
+		}
+	}
+
+	if (is_goal(S, goals)) {
+
+		best_cost = 0;
+	}
+
+	stats -> setup_ns = now_ns() - phase_start;
+	phase_start = now_ns();
+
+	while (!is_empty(search_frontier[0]) && !is_empty(search_frontier[1])) {
+
+		if (best_cost >= 0 && frontier_priority(search_frontier[0], peek(search_frontier[0])) + frontier_priority(search_frontier[1], peek(search_frontier[1])) >= best_cost) {
+
+			break;
+		}
+
+		side = (search_frontier[0] -> count <= search_frontier[1] -> count) ? 0 : 1;
+		other = 1 - side;
+
+		current_coordinates = peek(search_frontier[side]);
+		pop(search_frontier[side]);
+
+		if (is_visited(current_coordinates, visited[side], maze_size)) {
+
+			stats -> stale_pops++;
+			continue;
+		}
+
+		push_visited(current_coordinates, visited[side], maze_size);
+		stats -> closed_count++;
+
+		// Every move can be taken both ways, so both sides use the same transition operators.
+		for (move = 0; move < 8; move++) {
+
+			new_coordinates.x = current_coordinates.x + move_x[move];
+			new_coordinates.y = current_coordinates.y + move_y[move];
+
+			if (!in_maze(new_coordinates, maze_size) || maze_cell(maze, new_coordinates.x, new_coordinates.y) == 0 || is_visited(new_coordinates, visited[side], maze_size)) {
+
+				continue;
+			}
+
+			new_cost = cost[side][CELL_INDEX(current_coordinates, maze_size)] + 1;
+
+			if (!check_frontier(search_frontier[side], new_coordinates)) {
+
+				cost[side][CELL_INDEX(new_coordinates, maze_size)] = new_cost;
+				set_parent(parent[side], CELL_INDEX(new_coordinates, maze_size), move);
+				push(search_frontier[side], new_coordinates, new_cost);
+				expansion_count++;
+			}
+			else if (new_cost < cost[side][CELL_INDEX(new_coordinates, maze_size)]) {
+
+				cost[side][CELL_INDEX(new_coordinates, maze_size)] = new_cost;
+				set_parent(parent[side], CELL_INDEX(new_coordinates, maze_size), move);
+				decrease_key(search_frontier[side], new_coordinates, new_cost);
+			}
+
+			if (reached(search_frontier[other], visited[other], new_coordinates, maze_size)) {
+
+				new_cost = cost[side][CELL_INDEX(new_coordinates, maze_size)] + cost[other][CELL_INDEX(new_coordinates, maze_size)];
+				if (best_cost < 0 || new_cost < best_cost) {
+
+					best_cost = new_cost;
+					meeting_cell = new_coordinates;
+				}
+			}
+		}
+	}
+
+	stats -> search_ns = now_ns() - phase_start;
+	phase_start = now_ns();
+
+	if (best_cost >= 0) {
+
+		// Forward half: S to the meeting cell, from the forward parent moves.
+		path = reconstruct_path(parent[0], maze_size, S, meeting_cell, cost[0][CELL_INDEX(meeting_cell, maze_size)]);
+
+		// Backward half: the backward parent moves lead from the meeting cell to the goal that reached it.
+		path = (coordinates_t *)realloc(path, (best_cost + 1) * sizeof(coordinates_t));
+		if (path == NULL) {
+
+			printf("[Bidirectional] Trouble reallocating memory for 'path' array.\n");
+			exit(1);
+		}
+
+		goal_cell = meeting_cell;
+		for (i = cost[0][CELL_INDEX(meeting_cell, maze_size)] + 1; i <= best_cost; i++) {
+
+			move = get_parent(parent[1], CELL_INDEX(goal_cell, maze_size));
+			goal_cell.x -= move_x[move];
+			goal_cell.y -= move_y[move];
+			path[i] = goal_cell;
+		}
+
+		result -> goal = is_goal(goal_cell, goals);
+		result -> goal_cell = goal_cell;
+	}
+
+	result -> path_cost = best_cost;
+	result -> expansion_count = expansion_count;
+	result -> node_reuses = frontier_node_reuses(search_frontier[0]) + frontier_node_reuses(search_frontier[1]);
+	*meeting = meeting_cell;
+
+	stats -> output_ns = now_ns() - phase_start;
+	for (side = 0; side < 2; side++) {
+
+		collect_frontier_stats(search_frontier[side], stats);
+		stats -> bytes_allocated += search_memory_bytes((size_t)maze_size * maze_size);
+		free_frontier(search_frontier[side]);
+		free(visited[side]);
+		free(parent[side]);
+		free(cost[side]);
+	}
+
+	return path;
+}
+
+void bidirectional(maze_t *maze, coordinates_t S, goals_t *goals, int frontier_type) {
+
+	search_result_t result;
+	coordinates_t meeting_cell;
+	coordinates_t *path = bidirectional_search(maze, S, goals, frontier_type, &result, &meeting_cell);
+	long phase_start = now_ns();
+
+	if (path == NULL) {
+
+		print_unreachable(goals);
+	}
+	else {
+
+		printf("Reached G%d[%d][%d], meeting at [%d][%d].\n", result.goal, result.goal_cell.x, result.goal_cell.y, meeting_cell.x, meeting_cell.y);
+
+		print_path(path, result.path_cost + 1);
+		printf("Number of expansions: %d.\n", result.expansion_count);
+
+		free(path);
+	}
+
+	result.stats.output_ns += now_ns() - phase_start;
+	if (show_stats) {
+
+		print_search_stats(&(result.stats));
+	}
+}
+
+// -----------------------------------
+// 		  Hierarchical Search
+// -----------------------------------
+
+/*	HPA*: the maze is cut into square clusters and every run of free cells along a border between two
+	clusters becomes an entrance, a pair of transition cells one step apart. Transition cells are the
+	nodes of a small abstract graph, linked by those single steps and, inside every cluster, by their
+	distances within the cluster. new_hpa() builds the graph once per maze, hpa_search() then only
+	searches it and walks through the clusters its route crosses.
+	Routes are near optimal, not always optimal: they go through transition cells.
+*/
+#define HPA_CLUSTER_SIZE 32		// Cells per cluster side. Bigger clusters mean fewer abstract nodes and straighter routes, but a slower build.
+#define HPA_LONG_ENTRANCE 6		// Entrances at least this long get a transition at each end instead of one in the middle.
+
+typedef struct hpa_node_s {
+
+	coordinates_t cell;
+	int cluster;
+	int next;				// Next node of the same cluster, -1 at the end.
+	int first_edge;			// Edges of the node are edges[first_edge] to edges[first_edge + edge_count - 1].
+	int edge_count;
+}hpa_node_t;
+
+typedef struct hpa_edge_s {
+
+	int from, to;
+	int cost;
+}hpa_edge_t;
+
+typedef struct hpa_s {
+
+	maze_t *maze;
+	int cluster_size;
+	int clusters_per_side;
+	int *cluster_head;		// First node of every cluster, -1 if the cluster has none.
+	hpa_node_t *nodes;
+	int node_count, node_capacity;
+	hpa_edge_t *edges;		// Sorted by 'from'.
+	int edge_count, edge_capacity;
+}hpa_t;
+
+int hpa_cluster(hpa_t *hpa, coordinates_t cell) {
+
+	return (cell.x / hpa -> cluster_size) * hpa -> clusters_per_side + cell.y / hpa -> cluster_size;
+}
+
+int hpa_local_index(hpa_t *hpa, coordinates_t cell) {	// Index of a cell in its cluster's grid, see hpa_load_cluster().
+
+	return (cell.x % hpa -> cluster_size + 1) * (hpa -> cluster_size + 2) + cell.y % hpa -> cluster_size + 1;
+}
+
+void hpa_load_cluster(hpa_t *hpa, coordinates_t cell, int *grid) {
+
+	/*	Copies the cluster of 'cell' to 'grid', (cluster_size + 2)^2 ints: -1 for a free cell, -2 for an obstacle.
+		The cluster is framed by a ring of obstacles, so cluster_bfs() never has to check its bounds.
+	*/
+	int cluster_size = hpa -> cluster_size, width = cluster_size + 2;
+	int x0 = (cell.x / cluster_size) * cluster_size, y0 = (cell.y / cluster_size) * cluster_size;
+	int x, y;
+
+	for (x = 0; x < width * width; x++) {
+
+		grid[x] = -2;
+	}
+
+	for (x = x0; x < x0 + cluster_size && x < hpa -> maze -> size; x++) {
+		for (y = y0; y < y0 + cluster_size && y < hpa -> maze -> size; y++) {
+
+			if (maze_cell(hpa -> maze, x, y)) {
+
+				grid[(x - x0 + 1) * width + y - y0 + 1] = -1;
+			}
+		}
+	}
+}
+
+void cluster_bfs(hpa_t *hpa, int *grid, coordinates_t from, int *dist, int *queue) {
+
+	/*	Distances from 'from' to every cell of its cluster (loaded in 'grid'), moving only within the cluster,
+		indexed by hpa_local_index(). Unreachable cells and obstacles are negative. 'queue' holds cluster_size^2 ints.
+	*/
+	int width = hpa -> cluster_size + 2;
+	int offset[8];
+	int head = 0, tail = 0, move, local, next;
+
+	for (move = 0; move < 8; move++) {
+
+		offset[move] = move_x[move] * width + move_y[move];
+	}
+
+	memcpy(dist, grid, (size_t)width * width * sizeof(int));
+
+	local = hpa_local_index(hpa, from);
+	if (dist[local] != -1) {	// An obstacle reaches nothing, not even itself.
+
+		return;
+	}
+
+	dist[local] = 0;
+	queue[tail++] = local;
+
+	while (head < tail) {
+
+		local = queue[head++];
+
+		for (move = 0; move < 8; move++) {
+
+			next = local + offset[move];
+
+			if (dist[next] == -1) {
+
+				dist[next] = dist[local] + 1;
+				queue[tail++] = next;
+			}
+		}
+	}
+}
+
+int hpa_add_node(hpa_t *hpa, coordinates_t cell) {	// Returns the node of 'cell', adding it if it is new.
+
+	hpa_node_t *new_nodes = NULL;
+	int cluster = hpa_cluster(hpa, cell);
+	int i;
+
+	for (i = hpa -> cluster_head[cluster]; i >= 0; i = hpa -> nodes[i].next) {
+
+		if (hpa -> nodes[i].cell.x == cell.x && hpa -> nodes[i].cell.y == cell.y) {
+
+			return i;
+		}
+	}
+
+	if (hpa -> node_count == hpa -> node_capacity) {
+
+		hpa -> node_capacity = (hpa -> node_capacity == 0) ? 256 : 2 * hpa -> node_capacity;
+		new_nodes = (hpa_node_t *)realloc(hpa -> nodes, hpa -> node_capacity * sizeof(hpa_node_t));
+		if (new_nodes == NULL) {
+
+			printf("Trouble allocating memory for abstract graph nodes.\n");
+			exit(1);
+		}
+		hpa -> nodes = new_nodes;
+	}
+
+	i = hpa -> node_count++;
+	hpa -> nodes[i].cell = cell;
+	hpa -> nodes[i].cluster = cluster;
+	hpa -> nodes[i].next = hpa -> cluster_head[cluster];
+	hpa -> nodes[i].edge_count = 0;
+	hpa -> cluster_head[cluster] = i;
+
+	return i;
+}
+
+void hpa_add_edge(hpa_t *hpa, int from, int to, int cost) {
+
+	hpa_edge_t *new_edges = NULL;
+
+	if (hpa -> edge_count == hpa -> edge_capacity) {
+
+		hpa -> edge_capacity = (hpa -> edge_capacity == 0) ? 1024 : 2 * hpa -> edge_capacity;
+		new_edges = (hpa_edge_t *)realloc(hpa -> edges, hpa -> edge_capacity * sizeof(hpa_edge_t));
+		if (new_edges == NULL) {
+
+			printf("Trouble allocating memory for abstract graph edges.\n");
+			exit(1);
+		}
+		hpa -> edges = new_edges;
+	}
+
+	hpa -> edges[hpa -> edge_count].from = from;
+	hpa -> edges[hpa -> edge_count].to = to;
+	hpa -> edges[hpa -> edge_count].cost = cost;
+	hpa -> edge_count++;
+}
+
+void hpa_add_transition(hpa_t *hpa, coordinates_t a, coordinates_t b) {	// 'a' and 'b' are one step apart, in neighbouring clusters.
+
+	int from = hpa_add_node(hpa, a), to = hpa_add_node(hpa, b);
+
+	hpa_add_edge(hpa, from, to, 1);
+	hpa_add_edge(hpa, to, from, 1);
+}
+
+void hpa_add_entrance(hpa_t *hpa, coordinates_t start, int along_x, int along_y, int k) {	// Straight crossing k of a border, see hpa_add_border().
+
+	coordinates_t a, b;
+
+	a.x = start.x + k * along_x;
+	a.y = start.y + k * along_y;
+	b.x = a.x + along_y;
+	b.y = a.y + along_x;
+
+	hpa_add_transition(hpa, a, b);
+}
+
+void hpa_add_border(hpa_t *hpa, coordinates_t start, int along_x, int along_y, int length) {
+
+	/*	The border between the cells start + k * along and the cells one step across it, 0 <= k < length.
+		Crossing is possible straight over (a_k to b_k) or diagonally when the straight way is blocked.
+		A diagonal crossing from a corner of the border into the next cluster over is left out, hpa_search()
+		falls back to a flat search if the abstract graph misses a route.
+	*/
+	coordinates_t a, b, c, d;
+	int across_x = along_y, across_y = along_x;	// Borders run along x or along y, crossing is the other way.
+	int k, run_start = -1, free_a, free_b;
+
+	for (k = 0; k <= length; k++) {
+
+		a.x = start.x + k * along_x;
+		a.y = start.y + k * along_y;
+		b.x = a.x + across_x;
+		b.y = a.y + across_y;
+
+		free_a = (k < length) && maze_cell(hpa -> maze, a.x, a.y);
+		free_b = (k < length) && maze_cell(hpa -> maze, b.x, b.y);
+
+		if (free_a && free_b) {
+
+			if (run_start < 0) {
+
+				run_start = k;
+			}
+
+			continue;
+		}
+
+		// A run of straight crossings [run_start, k) ended.
+		if (run_start >= 0) {
+
+			if (k - run_start >= HPA_LONG_ENTRANCE) {
+
+				hpa_add_entrance(hpa, start, along_x, along_y, run_start);
+				hpa_add_entrance(hpa, start, along_x, along_y, k - 1);
+			}
+			else {
+
+				hpa_add_entrance(hpa, start, along_x, along_y, (run_start + k - 1) / 2);
+			}
+
+			run_start = -1;
+		}
+
+		if (k + 1 >= length) {
+
+			continue;
+		}
+
+		// Diagonal crossings between k and k + 1, only useful when neither straight crossing is open.
+		c.x = a.x + along_x;
+		c.y = a.y + along_y;
+		d.x = b.x + along_x;
+		d.y = b.y + along_y;
+
+		if (free_a && !free_b && !maze_cell(hpa -> maze, c.x, c.y) && maze_cell(hpa -> maze, d.x, d.y)) {
+
+			hpa_add_transition(hpa, a, d);
+		}
+
+		if (!free_a && free_b && maze_cell(hpa -> maze, c.x, c.y) && !maze_cell(hpa -> maze, d.x, d.y)) {
+
+			hpa_add_transition(hpa, c, b);
+		}
+	}
+}
+
+hpa_t *new_hpa(maze_t *maze, int cluster_size) {
+
+	hpa_t *hpa = NULL;
+	hpa_edge_t *sorted = NULL;
+	coordinates_t start;
+	int *grid = NULL, *dist = NULL, *queue = NULL, *first = NULL;
+	int maze_size = maze -> size;
+	int cx, cy, length, cluster, i, j;
+
+	hpa = (hpa_t *)calloc(1, sizeof(hpa_t));
+	if (hpa == NULL) {
+
+		printf("Trouble allocating memory for abstract graph.\n");
+		exit(1);
+	}
+
+	hpa -> maze = maze;
+	hpa -> cluster_size = cluster_size;
+	hpa -> clusters_per_side = (maze_size + cluster_size - 1) / cluster_size;
+
+	hpa -> cluster_head = (int *)malloc((size_t)hpa -> clusters_per_side * hpa -> clusters_per_side * sizeof(int));
+	grid = (int *)malloc((cluster_size + 2) * (cluster_size + 2) * sizeof(int));
+	dist = (int *)malloc((cluster_size + 2) * (cluster_size + 2) * sizeof(int));
+	queue = (int *)malloc(cluster_size * cluster_size * sizeof(int));
+	if (hpa -> cluster_head == NULL || grid == NULL || dist == NULL || queue == NULL) {
+
+		printf("Trouble allocating memory for abstract graph.\n");
+		exit(1);
+	}
+
+	for (i = 0; i < hpa -> clusters_per_side * hpa -> clusters_per_side; i++) {
+
+		hpa -> cluster_head[i] = -1;
+	}
+
+	// Entrances to the cluster on the right of and below every cluster.
+	for (cx = 0; cx < hpa -> clusters_per_side; cx++) {
+		for (cy = 0; cy < hpa -> clusters_per_side; cy++) {
+
+			if ((cy + 1) * cluster_size < maze_size) {
+
+				start.x = cx * cluster_size;
+				start.y = (cy + 1) * cluster_size - 1;
+				length = (maze_size - start.x < cluster_size) ? maze_size - start.x : cluster_size;
+				hpa_add_border(hpa, start, 1, 0, length);
+			}
+
+			if ((cx + 1) * cluster_size < maze_size) {
+
+				start.x = (cx + 1) * cluster_size - 1;
+				start.y = cy * cluster_size;
+				length = (maze_size - start.y < cluster_size) ? maze_size - start.y : cluster_size;
+				hpa_add_border(hpa, start, 0, 1, length);
+			}
+		}
+	}
+
+	// Distances between the transition cells of every cluster, within the cluster.
+	for (cluster = 0; cluster < hpa -> clusters_per_side * hpa -> clusters_per_side; cluster++) {
+
+		if (hpa -> cluster_head[cluster] < 0) {
+
+			continue;
+		}
+
+		hpa_load_cluster(hpa, hpa -> nodes[hpa -> cluster_head[cluster]].cell, grid);
+
+		for (i = hpa -> cluster_head[cluster]; i >= 0; i = hpa -> nodes[i].next) {
+
+			cluster_bfs(hpa, grid, hpa -> nodes[i].cell, dist, queue);
+
+			for (j = hpa -> cluster_head[cluster]; j >= 0; j = hpa -> nodes[j].next) {
+
+				if (j != i && dist[hpa_local_index(hpa, hpa -> nodes[j].cell)] > 0) {
+
+					hpa_add_edge(hpa, i, j, dist[hpa_local_index(hpa, hpa -> nodes[j].cell)]);
+				}
+			}
+		}
+	}
+
+	// Group the edges by the node they leave from (counting sort).
+	first = (int *)calloc(hpa -> node_count + 1, sizeof(int));
+	sorted = (hpa_edge_t *)malloc((hpa -> edge_count + 1) * sizeof(hpa_edge_t));
+	if (first == NULL || sorted == NULL) {
+
+		printf("Trouble allocating memory for abstract graph edges.\n");
+		exit(1);
+	}
+
+	for (i = 0; i < hpa -> edge_count; i++) {
+
+		hpa -> nodes[hpa -> edges[i].from].edge_count++;
+	}
+
+	for (i = 0; i < hpa -> node_count; i++) {
+
+		hpa -> nodes[i].first_edge = first[i];
+		first[i + 1] = first[i] + hpa -> nodes[i].edge_count;
+	}
+
+	for (i = 0; i < hpa -> edge_count; i++) {
+
+		sorted[first[hpa -> edges[i].from]++] = hpa -> edges[i];
+	}
+
+	free(hpa -> edges);
+	hpa -> edges = sorted;
+	hpa -> edge_capacity = hpa -> edge_count;
+
+	free(first);
+	free(grid);
+	free(dist);
+	free(queue);
+
+	return hpa;
+}
+
+void free_hpa(hpa_t *hpa) {	// The maze itself belongs to the caller.
+
+	free(hpa -> cluster_head);
+	free(hpa -> nodes);
+	free(hpa -> edges);
+	free(hpa);
+}
+
+int hpa_walk(hpa_t *hpa, coordinates_t from, coordinates_t to, coordinates_t *path, int *grid, int *dist, int *queue) {
+
+	/*	Writes the cells after 'from' up to and including 'to', both in the same cluster, to 'path'.
+		Returns how many were written.
+	*/
+	coordinates_t next;
+	int steps = 0, move;
+
+	hpa_load_cluster(hpa, to, grid);
+	cluster_bfs(hpa, grid, to, dist, queue);
+
+	while (from.x != to.x || from.y != to.y) {
+
+		// Downhill towards 'to', clockwise from up on ties so the route is always the same.
+		for (move = 0; move < 8; move++) {
+
+			next.x = from.x + move_x[move];
+			next.y = from.y + move_y[move];
+
+			if (in_maze(next, hpa -> maze -> size) && hpa_cluster(hpa, next) == hpa_cluster(hpa, to)
+				&& dist[hpa_local_index(hpa, next)] == dist[hpa_local_index(hpa, from)] - 1) {
+
+				break;
+			}
+		}
+
+		from = next;
+		path[steps++] = from;
+	}
+
+	return steps;
+}
+
+typedef struct hpa_query_s {	// Abstract search state of one hpa_search() call.
+
+	frontier_t *frontier;
+	int side;				// Node i is stored in the frontier as cell [i / side][i % side].
+	int *g;					// -1 until a node is reached.
+	int *parent;
+	unsigned char *closed;
+	goals_t *goals;
+	int expansion_count;
+}hpa_query_t;
+
+void hpa_relax(hpa_query_t *query, int current, int next, int d, coordinates_t next_cell) {	// Abstract edge of cost 'd' (-1 for none).
+
+	coordinates_t key;
+	int cost = query -> g[current] + d;
+
+	if (d < 0 || query -> closed[next]) {
+
+		return;
+	}
+
+	key.x = next / query -> side;
+	key.y = next % query -> side;
+
+	if (query -> g[next] < 0) {
+
+		query -> g[next] = cost;
+		query -> parent[next] = current;
+		push(query -> frontier, key, cost + goal_heuristic(next_cell, query -> goals));
+		query -> expansion_count++;
+	}
+	else if (cost < query -> g[next]) {
+
+		query -> g[next] = cost;
+		query -> parent[next] = current;
+		decrease_key(query -> frontier, key, cost + goal_heuristic(next_cell, query -> goals));
+	}
+}
+
+coordinates_t *hpa_search(hpa_t *hpa, coordinates_t S, goals_t *goals, search_result_t *result) {
+
+	/*	Abstract A* from S to the closest exit, S and the exits joining the graph for this query only
+		(as nodes node_count and node_count + 1 + k), then every abstract edge is walked through its cluster.
+		Only reads 'hpa', so queries can run side by side. Returns the route, or NULL if no exit can be reached.
+	*/
+	hpa_query_t query;
+	workspace_t *workspace = NULL;
+	search_stats_t *stats = &(result -> stats);
+	coordinates_t *path = NULL;
+	coordinates_t key, cell, next_cell;
+	hpa_node_t *node = NULL;
+	int *grid = NULL, *start_dist = NULL, *goal_dist = NULL, *queue = NULL, *route = NULL;
+	int area = (hpa -> cluster_size + 2) * (hpa -> cluster_size + 2);
+	int S_id = hpa -> node_count, node_total = hpa -> node_count + 1 + goals -> count;
+	int current, goal_node = -1, route_count = 0, path_count, i, k;
+	long phase_start = now_ns();
+
+	if (!can_reach(hpa -> maze, S, goals)) {
+
+		set_unreachable(result);
+		return NULL;
+	}
+
+	memset(stats, 0, sizeof(search_stats_t));
+
+	query.side = 1;
+	while (query.side * query.side < node_total) {
+
+		query.side++;
+	}
+
+	query.goals = goals;
+	query.expansion_count = 0;
+	query.g = (int *)malloc(node_total * sizeof(int));
+	query.parent = (int *)malloc(node_total * sizeof(int));
+	query.closed = (unsigned char *)calloc(node_total, sizeof(unsigned char));
+	route = (int *)malloc(node_total * sizeof(int));
+	grid = (int *)malloc(area * sizeof(int));
+	start_dist = (int *)malloc(area * sizeof(int));
+	goal_dist = (int *)malloc((size_t)goals -> count * area * sizeof(int));
+	queue = (int *)malloc(area * sizeof(int));
+	if (query.g == NULL || query.parent == NULL || query.closed == NULL || route == NULL || grid == NULL || start_dist == NULL || goal_dist == NULL || queue == NULL) {
+
+		printf("[HPA*] Trouble allocating memory for abstract search.\n");
+		exit(1);
+	}
+
+	for (i = 0; i < node_total; i++) {
+
+		query.g[i] = -1;
+	}
+
+	// S and the exits reach the transition cells of their own cluster.
+	hpa_load_cluster(hpa, S, grid);
+	cluster_bfs(hpa, grid, S, start_dist, queue);
+	for (k = 0; k < goals -> count; k++) {
+
+		hpa_load_cluster(hpa, goals -> cells[k], grid);
+		cluster_bfs(hpa, grid, goals -> cells[k], goal_dist + (size_t)k * area, queue);
+	}
+
+	query.frontier = new_frontier(FRONTIER_QUATERNARY_HEAP, query.side);
+
+	query.g[S_id] = 0;
+	key.x = S_id / query.side;
+	key.y = S_id % query.side;
+	push(query.frontier, key, goal_heuristic(S, goals));
+
+	stats -> setup_ns = now_ns() - phase_start;
+	phase_start = now_ns();
+
+	while (!is_empty(query.frontier)) {
+
+		key = peek(query.frontier);
+		pop(query.frontier);
+
+		current = key.x * query.side + key.y;
+		query.closed[current] = 1;
+		stats -> closed_count++;
+
+		if (current > S_id) {
+
+			goal_node = current;
+			break;
+		}
+
+		if (current == S_id) {
+
+			cell = S;
+			for (k = hpa -> cluster_head[hpa_cluster(hpa, S)]; k >= 0; k = hpa -> nodes[k].next) {
+
+				hpa_relax(&query, current, k, start_dist[hpa_local_index(hpa, hpa -> nodes[k].cell)], hpa -> nodes[k].cell);
+			}
+		}
+		else {
+
+			node = &(hpa -> nodes[current]);
+			cell = node -> cell;
+			for (k = node -> first_edge; k < node -> first_edge + node -> edge_count; k++) {
+
+				hpa_relax(&query, current, hpa -> edges[k].to, hpa -> edges[k].cost, hpa -> nodes[hpa -> edges[k].to].cell);
+			}
+		}
+
+		// Exits in the same cluster, at their distance within the cluster.
+		for (k = 0; k < goals -> count; k++) {
+
+			if (hpa_cluster(hpa, goals -> cells[k]) == hpa_cluster(hpa, cell)) {
+
+				hpa_relax(&query, current, S_id + 1 + k, goal_dist[(size_t)k * area + hpa_local_index(hpa, cell)], goals -> cells[k]);
+			}
+		}
+	}
+
+	stats -> search_ns = now_ns() - phase_start;
+	phase_start = now_ns();
+
+	if (goal_node >= 0) {
+
+		// Abstract route, exit first.
+		for (current = goal_node; current != S_id; current = query.parent[current]) {
+
+			route[route_count++] = current;
+		}
+
+		path = (coordinates_t *)malloc((query.g[goal_node] + 1) * sizeof(coordinates_t));
+		if (path == NULL) {
+
+			printf("[HPA*] Trouble allocating memory for 'path' array.\n");
+			exit(1);
+		}
+
+		path[0] = S;
+		path_count = 1;
+		for (i = route_count - 1; i >= 0; i--) {
+
+			next_cell = (route[i] > S_id) ? goals -> cells[route[i] - S_id - 1] : hpa -> nodes[route[i]].cell;
+			cell = path[path_count - 1];
+
+			if (hpa_cluster(hpa, cell) != hpa_cluster(hpa, next_cell)) {
+
+				path[path_count++] = next_cell;		// A transition, one step.
+			}
+			else {
+
+				path_count += hpa_walk(hpa, cell, next_cell, path + path_count, grid, start_dist, queue);
+			}
+		}
+
+		result -> goal = goal_node - S_id;
+		result -> goal_cell = goals -> cells[goal_node - S_id - 1];
+		result -> path_cost = query.g[goal_node];
+		result -> expansion_count = query.expansion_count;
+		result -> node_reuses = frontier_node_reuses(query.frontier);
+
+		stats -> output_ns = now_ns() - phase_start;
+		collect_frontier_stats(query.frontier, stats);
+		stats -> bytes_allocated += (size_t)node_total * (3 * sizeof(int) + 1) + (size_t)(goals -> count + 3) * area * sizeof(int);
+	}
+	else {
+
+		// The abstract graph leaves out corner crossings between diagonal clusters, search the grid itself.
+		workspace = new_workspace(FRONTIER_BINARY_HEAP, hpa -> maze -> size);
+		best_first(workspace, hpa -> maze, S, goals, 1, result);
+		if (result -> goal != 0) {
+
+			path = reconstruct_path(workspace -> parent, hpa -> maze -> size, S, result -> goal_cell, result -> path_cost);
+		}
+
+		free_workspace(workspace);
+	}
+
+	free_frontier(query.frontier);
+	free(query.g);
+	free(query.parent);
+	free(query.closed);
+	free(route);
+	free(grid);
+	free(start_dist);
+	free(goal_dist);
+	free(queue);
+
+	return path;
+}
+
+void hpa_star(hpa_t *hpa, coordinates_t S, goals_t *goals) {
+
+	search_result_t result;
+	coordinates_t *path = hpa_search(hpa, S, goals, &result);
+	long phase_start = now_ns();
+
+	if (path == NULL) {
+
+		print_unreachable(goals);
+	}
+	else {
+
+		printf("Reached G%d[%d][%d].\n", result.goal, result.goal_cell.x, result.goal_cell.y);
+
+		print_path(path, result.path_cost + 1);
+		printf("Number of expansions: %d.\n", result.expansion_count);
+
+		free(path);
+	}
+
+	result.stats.output_ns += now_ns() - phase_start;
+	if (show_stats) {
+
+		print_search_stats(&(result.stats));
+	}
+}
+
+// -----------------------------------
+// 			   D* Lite
+// -----------------------------------
+
+/*	Incremental planning for a maze whose cells change between queries. The search runs backward, from
+	every exit (rhs = 0) towards S, and keeps g(n) for every cell it settled. When a cell is opened or
+	closed, only the cells whose distance to an exit actually changed are expanded again, so replanning
+	costs about as much as the change, not the maze. Keys are pairs, [min(g, rhs) + h + km, min(g, rhs)],
+	so D* Lite keeps its own heap instead of the frontier.
+*/
+#define DSTAR_INFINITY 0x3FFFFFFF	// Unreachable. Sums of two of these and a heuristic still fit an int.
+
+typedef struct dstar_node_s {
+
+	int k1, k2;				// Key, compared lexicographically.
+	size_t cell;			// CELL_INDEX of the cell.
+}dstar_node_t;
+
+typedef struct dstar_s {
+
+	maze_t *maze;			// Changed through dstar_set_cell() only.
+	goals_t *goals;
+	coordinates_t start;
+	coordinates_t last;		// Start when 'km' was last updated.
+	int km;					// Heuristic drift since the search began, as the start moved.
+	int *g, *rhs;			// Settled and one step lookahead distance to the closest exit, per cell.
+	dstar_node_t *heap;		// Binary heap of inconsistent cells (g != rhs), smallest key first.
+	int heap_count, heap_capacity;
+	int *position;			// Heap slot of every cell, -1 while the cell is not in the heap.
+	int expansion_count;	// Cells expanded by the last dstar_plan().
+}dstar_t;
+
+int dstar_less(dstar_node_t a, dstar_node_t b) {
+
+	return a.k1 < b.k1 || (a.k1 == b.k1 && a.k2 < b.k2);
+}
+
+void dstar_place(dstar_t *dstar, int slot, dstar_node_t node) {
+
+	dstar -> heap[slot] = node;
+	dstar -> position[node.cell] = slot;
+}
+
+void dstar_sift(dstar_t *dstar, int slot) {	// Move a node up or down until the heap order holds again.
+
+	dstar_node_t node = dstar -> heap[slot];
+	int parent, child;
+
+	while (slot > 0 && dstar_less(node, dstar -> heap[(slot - 1) / 2])) {
+
+		parent = (slot - 1) / 2;
+		dstar_place(dstar, slot, dstar -> heap[parent]);
+		slot = parent;
+	}
+
+	while ((child = 2 * slot + 1) < dstar -> heap_count) {
+
+		if (child + 1 < dstar -> heap_count && dstar_less(dstar -> heap[child + 1], dstar -> heap[child])) {
+
+			child++;
+		}
+
+		if (!dstar_less(dstar -> heap[child], node)) {
+
+			break;
+		}
+
+		dstar_place(dstar, slot, dstar -> heap[child]);
+		slot = child;
+	}
+
+	dstar_place(dstar, slot, node);
+}
+
+void dstar_remove(dstar_t *dstar, size_t cell) {
+
+	int slot = dstar -> position[cell];
+
+	if (slot < 0) {
+
+		return;
+	}
+
+	dstar -> position[cell] = -1;
+	dstar -> heap_count--;
+
+	if (slot < dstar -> heap_count) {
+
+		dstar_place(dstar, slot, dstar -> heap[dstar -> heap_count]);
+		dstar_sift(dstar, slot);
+	}
+}
+
+coordinates_t dstar_coordinates(dstar_t *dstar, size_t cell) {
+
+	coordinates_t coordinates;
+
+	coordinates.x = cell / dstar -> maze -> size;
+	coordinates.y = cell % dstar -> maze -> size;
+
+	return coordinates;
+}
+
+dstar_node_t dstar_key(dstar_t *dstar, size_t cell) {
+
+	dstar_node_t node;
+	int g = (dstar -> g[cell] < dstar -> rhs[cell]) ? dstar -> g[cell] : dstar -> rhs[cell];
+
+	node.k1 = g + heuristic(dstar -> start, dstar_coordinates(dstar, cell)) + dstar -> km;
+	node.k2 = g;
+	node.cell = cell;
+
+	return node;
+}
+
+void dstar_update(dstar_t *dstar, size_t cell) {
+
+	/*	Recompute rhs of 'cell' from its neighbours, and keep it in the heap exactly while it is inconsistent.
+		Every step costs 1, and any step from or to an obstacle costs DSTAR_INFINITY.
+	*/
+	dstar_node_t *new_heap = NULL;
+	coordinates_t current = dstar_coordinates(dstar, cell), next;
+	int maze_size = dstar -> maze -> size;
+	int move, best = DSTAR_INFINITY;
+
+	if (is_goal(current, dstar -> goals)) {
+
+		best = 0;
+	}
+	else if (maze_cell(dstar -> maze, current.x, current.y)) {
+
+		for (move = 0; move < 8; move++) {
+
+			next.x = current.x + move_x[move];
+			next.y = current.y + move_y[move];
+
+			if (in_maze(next, maze_size) && maze_cell(dstar -> maze, next.x, next.y) && dstar -> g[CELL_INDEX(next, maze_size)] + 1 < best) {
+
+				best = dstar -> g[CELL_INDEX(next, maze_size)] + 1;
+			}
+		}
+	}
+
+	dstar -> rhs[cell] = best;
+
+	if (dstar -> g[cell] == dstar -> rhs[cell]) {
+
+		dstar_remove(dstar, cell);
+		return;
+	}
+
+	if (dstar -> position[cell] < 0) {
+
+		if (dstar -> heap_count == dstar -> heap_capacity) {
+
+			dstar -> heap_capacity = (dstar -> heap_capacity == 0) ? 1024 : 2 * dstar -> heap_capacity;
+			new_heap = (dstar_node_t *)realloc(dstar -> heap, dstar -> heap_capacity * sizeof(dstar_node_t));
+			if (new_heap == NULL) {
+
+				printf("[D* Lite] Trouble allocating memory for heap.\n");
+				exit(1);
+			}
+			dstar -> heap = new_heap;
+		}
+
+		dstar -> position[cell] = dstar -> heap_count++;
+	}
+
+	dstar -> heap[dstar -> position[cell]] = dstar_key(dstar, cell);
+	dstar_sift(dstar, dstar -> position[cell]);
+}
+
+void dstar_update_neighbours(dstar_t *dstar, size_t cell) {
+
+	coordinates_t current = dstar_coordinates(dstar, cell), next;
+	int move;
+
+	for (move = 0; move < 8; move++) {
+
+		next.x = current.x + move_x[move];
+		next.y = current.y + move_y[move];
+
+		if (in_maze(next, dstar -> maze -> size)) {
+
+			dstar_update(dstar, CELL_INDEX(next, dstar -> maze -> size));
+		}
+	}
+}
+
+dstar_t *new_dstar(maze_t *maze, coordinates_t S, goals_t *goals) {
+
+	dstar_t *dstar = NULL;
+	size_t i, cell_count = (size_t)maze -> size * maze -> size;
+	int k;
+
+	dstar = (dstar_t *)calloc(1, sizeof(dstar_t));
+	if (dstar == NULL) {
+
+		printf("[D* Lite] Trouble allocating memory for planner.\n");
+		exit(1);
+	}
+
+	dstar -> maze = maze;
+	dstar -> goals = goals;
+	dstar -> start = S;
+	dstar -> last = S;
+	dstar -> km = 0;
+
+	dstar -> g = (int *)malloc(cell_count * sizeof(int));
+	dstar -> rhs = (int *)malloc(cell_count * sizeof(int));
+	dstar -> position = (int *)malloc(cell_count * sizeof(int));
+	if (dstar -> g == NULL || dstar -> rhs == NULL || dstar -> position == NULL) {
+
+		printf("[D* Lite] Trouble allocating memory for planner.\n");
+		exit(1);
+	}
+
+	for (i = 0; i < cell_count; i++) {
+
+		dstar -> g[i] = DSTAR_INFINITY;
+		dstar -> rhs[i] = DSTAR_INFINITY;
+		dstar -> position[i] = -1;
+	}
+
+	// Every exit is a source.
+	for (k = 0; k < goals -> count; k++) {
+
+		dstar_update(dstar, CELL_INDEX(goals -> cells[k], maze -> size));
+	}
+
+	return dstar;
+}
+
+void free_dstar(dstar_t *dstar) {	// The maze and the exits belong to the caller.
+
+	free(dstar -> g);
+	free(dstar -> rhs);
+	free(dstar -> heap);
+	free(dstar -> position);
+	free(dstar);
+}
+
+int dstar_plan(dstar_t *dstar) {
+
+	/*	Expands inconsistent cells until S is consistent and nothing left in the heap can improve it.
+		Returns the distance from S to the closest exit, -1 if there is no route.
+	*/
+	dstar_node_t top, key;
+	size_t start = CELL_INDEX(dstar -> start, dstar -> maze -> size);
+	size_t cell;
+
+	dstar -> expansion_count = 0;
+
+	if (!can_reach(dstar -> maze, dstar -> start, dstar -> goals)) {
+
+		return -1;
+	}
+
+	while (dstar -> heap_count > 0 && (dstar_less(dstar -> heap[0], dstar_key(dstar, start)) || dstar -> rhs[start] != dstar -> g[start])) {
+
+		top = dstar -> heap[0];
+		cell = top.cell;
+		key = dstar_key(dstar, cell);
+		dstar -> expansion_count++;
+
+		if (dstar_less(top, key)) {		// Key went stale as the start moved.
+
+			dstar -> heap[0] = key;
+			dstar_sift(dstar, 0);
+		}
+		else if (dstar -> g[cell] > dstar -> rhs[cell]) {	// Got closer to an exit, settle it.
+
+			dstar -> g[cell] = dstar -> rhs[cell];
+			dstar_remove(dstar, cell);
+			dstar_update_neighbours(dstar, cell);
+		}
+		else {		// Got further away, forget it and let it and its neighbours find a new way.
+
+			dstar -> g[cell] = DSTAR_INFINITY;
+			dstar_update(dstar, cell);
+			dstar_update_neighbours(dstar, cell);
+		}
+	}
+
+	return (dstar -> rhs[start] >= DSTAR_INFINITY) ? -1 : dstar -> rhs[start];
+}
+
+void dstar_set_cell(dstar_t *dstar, int x, int y, int value) {	// Open (1) or close (0) a cell, dstar_plan() then repairs the route.
+
+	coordinates_t cell;
+
+	cell.x = x;
+	cell.y = y;
+
+	if (maze_cell(dstar -> maze, x, y) == (value != 0)) {
+
+		return;
+	}
+
+	set_maze_cell(dstar -> maze, x, y, value);
+
+	// Steps into or out of the cell changed cost, which changes rhs of the cell and its neighbours.
+	dstar_update(dstar, CELL_INDEX(cell, dstar -> maze -> size));
+	dstar_update_neighbours(dstar, CELL_INDEX(cell, dstar -> maze -> size));
+}
+
+void dstar_move(dstar_t *dstar, coordinates_t new_start) {	// The agent moved, keys already in the heap stay comparable through 'km'.
+
+	dstar -> km += heuristic(dstar -> last, new_start);
+	dstar -> last = new_start;
+	dstar -> start = new_start;
+}
+
+coordinates_t *dstar_path(dstar_t *dstar, int path_cost) {	// Route after dstar_plan() returned 'path_cost' >= 0.
+
+	coordinates_t *path = NULL;
+	coordinates_t current = dstar -> start, next, best_next;
+	int maze_size = dstar -> maze -> size;
+	int i, move, best;
+
+	path = (coordinates_t *)malloc((path_cost + 1) * sizeof(coordinates_t));
+	if (path == NULL) {
+
+		printf("[D* Lite] Trouble allocating memory for 'path' array.\n");
+		exit(1);
+	}
+
+	path[0] = current;
+
+	// Downhill on g, clockwise from up on ties.
+	for (i = 1; i <= path_cost; i++) {
+
+		best = DSTAR_INFINITY;
+		best_next = current;
+
+		for (move = 0; move < 8; move++) {
+
+			next.x = current.x + move_x[move];
+			next.y = current.y + move_y[move];
+
+			if (in_maze(next, maze_size) && maze_cell(dstar -> maze, next.x, next.y) && dstar -> g[CELL_INDEX(next, maze_size)] < best) {
+
+				best = dstar -> g[CELL_INDEX(next, maze_size)];
+				best_next = next;
+			}
+		}
+
+		current = best_next;
+		path[i] = current;
+	}
+
+	return path;
+}
+
+void d_star_lite(dstar_t *dstar) {
+
+	coordinates_t *path = NULL;
+	int path_cost = dstar_plan(dstar);
+	int goal;
+
+	if (path_cost < 0) {
+
+		print_unreachable(dstar -> goals);
+		return;
+	}
+
+	path = dstar_path(dstar, path_cost);
+	goal = is_goal(path[path_cost], dstar -> goals);
+
+	printf("Reached G%d[%d][%d].\n", goal, path[path_cost].x, path[path_cost].y);
+
+	print_path(path, path_cost + 1);
+	printf("Number of expansions: %d.\n", dstar -> expansion_count);
+
+	free(path);
+}
+
+// -----------------------------------
+// 			Wavefront Search
+// -----------------------------------
+
+/*	Every step costs 1, so uniform cost search is a breadth first flood, and the flood can advance
+	64 cells at a time on the bit-packed rows. With F the current wavefront, row x of the next one is
+		spread(F[x - 1] | F[x] | F[x + 1]) & open[x] & ~visited[x]
+	where spread() ors a row with itself shifted one cell either way, which covers all eight moves.
+	Each reached cell keeps its distance modulo 3 in two bit planes: a neighbour one step closer to S
+	is the only one holding (d - 1) mod 3, which is all the route needs to be walked back.
+*/
+void spread_row(uint64_t *row, uint64_t *spread, int stride) {	// spread[y] = row[y - 1] | row[y] | row[y + 1].
+
+	int w;
+
+	// Plain word loop, no branches on the data, so the compiler can widen it to SIMD registers.
+	for (w = 0; w < stride; w++) {
+
+		spread[w] = row[w] | (row[w] << 1) | (row[w] >> 1)
+			| ((w > 0) ? row[w - 1] >> 63 : 0)
+			| ((w + 1 < stride) ? row[w + 1] << 63 : 0);
+	}
+}
+
+int distance_mod_3(uint64_t *plane_0, uint64_t *plane_1, size_t word, uint64_t bit) {
+
+	return ((plane_0[word] & bit) ? 1 : 0) | ((plane_1[word] & bit) ? 2 : 0);
+}
+
+typedef struct wavefront_s {
+
+	maze_t *maze;			// Shared by every worker, read only.
+	goals_t *goals;
+	uint64_t *front[2];		// The wavefront and the next one, each worker swaps its own copies every round.
+	int *span[2];			// First and last word of each row holding cells of front[0] and front[1].
+	uint64_t *visited;
+	uint64_t *plane[2];		// Distance modulo 3 of the reached cells, low and high bit.
+	uint64_t *goal_mask;
+	int first_row, last_row;	// Rows of the first wavefront.
+	int distance;			// Rounds run, set by the first worker when the flood stops.
+	int goal;
+	int thread_count;		// Workers flooding the current rounds, 1 while the wavefront is narrow.
+	int max_threads;
+	pthread_barrier_t barrier;
+	struct wavefront_job_s *jobs;
+}wavefront_t;
+
+typedef struct wavefront_job_s {
+
+	wavefront_t *wavefront;
+	int index;
+	uint64_t *row;			// Or of three rows, then its spread.
+	int new_first, new_last;	// Rows of the next wavefront this worker found cells in,
+	uint64_t reached_goal;		// and the exits among them, read by every worker once the round is over.
+}wavefront_job_t;
+
+#define WAVEFRONT_BAND_ROWS 32	// Fewest rows per worker worth two barriers a round.
+
+int wavefront_team(wavefront_t *wavefront, int first_row, int last_row, int thread_count) {
+
+	/*	Workers for the next round, given the rows of the wavefront and the workers of the last one.
+		Narrow wavefronts are flooded by a single thread with no barriers at all. A team is only started
+		on twice the rows it stops at, so a wavefront around the limit doesn't start threads every round.
+	*/
+	int rows = last_row - first_row + 3;
+
+	if (thread_count > 1) {
+
+		return (rows >= WAVEFRONT_BAND_ROWS * thread_count) ? thread_count : 1;
+	}
+
+	return (wavefront -> max_threads > 1 && rows >= 2 * WAVEFRONT_BAND_ROWS * wavefront -> max_threads) ? wavefront -> max_threads : 1;
+}
+
+void *wavefront_worker(void *argument) {
+
+	/*	Runs rounds on its own band of rows: it writes only those rows of the next wavefront and of
+		the bit planes, and only reads the current wavefront, so no cell is ever claimed by two workers and
+		nothing has to be atomic. After a round every worker combines all the bands' results by itself,
+		so they all agree on what comes next without waiting on a single thread, and all of them stop
+		in the same round once wavefront_team() asks for another number of workers.
+	*/
+	wavefront_job_t *job = (wavefront_job_t *)argument;
+	wavefront_t *wavefront = job -> wavefront;
+	maze_t *maze = wavefront -> maze;
+	goals_t *goals = wavefront -> goals;
+	uint64_t *front = wavefront -> front[0], *next_front = wavefront -> front[1], *temp = NULL;
+	uint64_t *visited = wavefront -> visited, *plane_0 = wavefront -> plane[0], *plane_1 = wavefront -> plane[1];
+	uint64_t *open = maze -> cells, *row = job -> row, bit, reached_goal;
+	int *front_span = wavefront -> span[0], *next_span = wavefront -> span[1], *temp_span = NULL;
+	size_t word;
+	int maze_size = maze -> size, stride = maze -> stride, thread_count = wavefront -> thread_count;
+	int first_row = wavefront -> first_row, last_row = wavefront -> last_row, goal = wavefront -> goal, distance = wavefront -> distance;
+	int new_first, new_last, first_band, last_band, first_word, last_word, x, w, k;
+
+	// One round per distance. The wavefront lies in rows [first_row, last_row] and, in each of those, between the words of its span.
+	while (goal == 0 && first_row <= last_row && wavefront_team(wavefront, first_row, last_row, thread_count) == thread_count) {
+
+		distance++;
+		new_first = (first_row > 0) ? first_row - 1 : 0;
+		new_last = (last_row + 1 < maze_size) ? last_row + 1 : maze_size - 1;
+		first_band = new_first + (int)((long)(new_last - new_first + 1) * job -> index / thread_count);
+		last_band = new_first + (int)((long)(new_last - new_first + 1) * (job -> index + 1) / thread_count);
+
+		job -> new_first = maze_size;
+		job -> new_last = -1;
+		reached_goal = 0;
+
+		for (x = first_band; x < last_band; x++) {
+
+			// Words of row x the next wavefront can reach: the spans of the rows around it, widened by a word for the carries.
+			first_word = stride;
+			last_word = -1;
+			for (k = (x > 0) ? x - 1 : 0; k <= x + 1 && k < maze_size; k++) {
+
+				first_word = (front_span[2 * k] < first_word) ? front_span[2 * k] : first_word;
+				last_word = (front_span[2 * k + 1] > last_word) ? front_span[2 * k + 1] : last_word;
+			}
+
+			if (first_word > last_word) {
+
+				continue;
+			}
+
+			first_word = (first_word > 0) ? first_word - 1 : 0;
+			last_word = (last_word + 1 < stride) ? last_word + 1 : stride - 1;
+
+			for (w = first_word; w <= last_word; w++) {
+
+				row[w] = front[(size_t)x * stride + w]
+					| ((x > 0) ? front[(size_t)(x - 1) * stride + w] : 0)
+					| ((x + 1 < maze_size) ? front[(size_t)(x + 1) * stride + w] : 0);
+			}
+
+			// The words around the range are empty, so the range can be spread on its own.
+			spread_row(row + first_word, row + stride + first_word, last_word - first_word + 1);
+
+			for (w = first_word; w <= last_word; w++) {
+
+				word = (size_t)x * stride + w;
+				bit = row[stride + w] & open[word] & ~visited[word];
+				next_front[word] = bit;
+
+				if (bit != 0) {
+
+					visited[word] |= bit;
+					plane_0[word] |= (distance % 3 == 1) ? bit : 0;
+					plane_1[word] |= (distance % 3 == 2) ? bit : 0;
+					reached_goal |= bit & wavefront -> goal_mask[word];
+
+					next_span[2 * x] = (w < next_span[2 * x]) ? w : next_span[2 * x];
+					next_span[2 * x + 1] = w;
+				}
+			}
+
+			if (next_span[2 * x] <= next_span[2 * x + 1]) {
+
+				job -> new_first = (x < job -> new_first) ? x : job -> new_first;
+				job -> new_last = x;
+			}
+		}
+
+		job -> reached_goal = reached_goal;
+
+		if (thread_count > 1) {
+
+			pthread_barrier_wait(&(wavefront -> barrier));
+		}
+
+		new_first = maze_size;
+		new_last = -1;
+		reached_goal = 0;
+		for (k = 0; k < thread_count; k++) {
+
+			new_first = (wavefront -> jobs[k].new_first < new_first) ? wavefront -> jobs[k].new_first : new_first;
+			new_last = (wavefront -> jobs[k].new_last > new_last) ? wavefront -> jobs[k].new_last : new_last;
+			reached_goal |= wavefront -> jobs[k].reached_goal;
+		}
+
+		// The old wavefront becomes the next round's output, each worker clears its band of what it held.
+		first_band = first_row + (int)((long)(last_row - first_row + 1) * job -> index / thread_count);
+		last_band = first_row + (int)((long)(last_row - first_row + 1) * (job -> index + 1) / thread_count);
+
+		for (x = first_band; x < last_band; x++) {
+
+			if (front_span[2 * x] <= front_span[2 * x + 1]) {
+
+				memset(front + (size_t)x * stride + front_span[2 * x], 0, (front_span[2 * x + 1] - front_span[2 * x] + 1) * sizeof(uint64_t));
+			}
+			front_span[2 * x] = stride;
+			front_span[2 * x + 1] = -1;
+		}
+
+		temp = front;
+		front = next_front;
+		next_front = temp;
+		temp_span = front_span;
+		front_span = next_span;
+		next_span = temp_span;
+		first_row = new_first;
+		last_row = new_last;
+
+		if (reached_goal != 0) {
+
+			// Several exits may be reached in the same round, report the first one.
+			for (k = 0; k < goals -> count && goal == 0; k++) {
+
+				if (front[(size_t)goals -> cells[k].x * stride + (goals -> cells[k].y >> 6)] & ((uint64_t)1 << (goals -> cells[k].y & 63))) {
+
+					goal = k + 1;
+				}
+			}
+		}
+
+		// Nobody writes the next wavefront before everyone is done clearing it and reading the bands' results.
+		if (thread_count > 1) {
+
+			pthread_barrier_wait(&(wavefront -> barrier));
+		}
+	}
+
+	// Every worker swapped the same buffers, the first one hands the flood over to the next rounds.
+	if (job -> index == 0) {
+
+		wavefront -> front[0] = front;
+		wavefront -> front[1] = next_front;
+		wavefront -> span[0] = front_span;
+		wavefront -> span[1] = next_span;
+		wavefront -> first_row = first_row;
+		wavefront -> last_row = last_row;
+		wavefront -> distance = distance;
+		wavefront -> goal = goal;
+	}
+
+	return NULL;
+}
+
+coordinates_t *wavefront_search(maze_t *maze, coordinates_t S, goals_t *goals, int thread_count, search_result_t *result) {
+
+	/*	Floods from S a whole wavefront per round, on up to 'thread_count' threads, until it touches an exit.
+		Returns the route, or NULL if no exit can be reached. result -> expansion_count is the number of cells reached.
+		The distances don't depend on how the rows are split, and the route is walked back by a single thread,
+		so the same maze always gives the same route for any 'thread_count'.
+	*/
+	search_stats_t *stats = &(result -> stats);
+	wavefront_t wavefront;
+	pthread_t *threads = NULL;
+	coordinates_t *path = NULL;
+	coordinates_t current, next;
+	uint64_t bit;
+	size_t words, word;
+	int maze_size = maze -> size, stride = maze -> stride;
+	int distance, goal, x, k, move;
+	long phase_start = now_ns();
+
+	memset(stats, 0, sizeof(search_stats_t));
+
+	if (!can_reach(maze, S, goals)) {
+
+		set_unreachable(result);
+		return NULL;
+	}
+
+	if (thread_count < 1) {
+
+		thread_count = 1;
+	}
+
+	if (thread_count > maze_size) {
+
+		thread_count = maze_size;
+	}
+
+	words = (size_t)maze_size * stride;
+	wavefront.maze = maze;
+	wavefront.goals = goals;
+	wavefront.front[0] = (uint64_t *)calloc(words, sizeof(uint64_t));
+	wavefront.front[1] = (uint64_t *)calloc(words, sizeof(uint64_t));
+	wavefront.span[0] = (int *)malloc(2 * maze_size * sizeof(int));
+	wavefront.span[1] = (int *)malloc(2 * maze_size * sizeof(int));
+	wavefront.visited = (uint64_t *)calloc(words, sizeof(uint64_t));
+	wavefront.plane[0] = (uint64_t *)calloc(words, sizeof(uint64_t));
+	wavefront.plane[1] = (uint64_t *)calloc(words, sizeof(uint64_t));
+	wavefront.goal_mask = (uint64_t *)calloc(words, sizeof(uint64_t));
+	wavefront.thread_count = 1;
+	wavefront.max_threads = thread_count;
+	wavefront.jobs = (wavefront_job_t *)malloc(thread_count * sizeof(wavefront_job_t));
+	threads = (pthread_t *)malloc(thread_count * sizeof(pthread_t));
+	if (wavefront.front[0] == NULL || wavefront.front[1] == NULL || wavefront.span[0] == NULL || wavefront.span[1] == NULL || wavefront.visited == NULL
+		|| wavefront.plane[0] == NULL || wavefront.plane[1] == NULL || wavefront.goal_mask == NULL || wavefront.jobs == NULL || threads == NULL) {
+
+		printf("[Wavefront] Trouble allocating memory for bit planes.\n");
+		exit(1);
+	}
+
+	for (x = 0; x < maze_size; x++) {
+
+		wavefront.span[0][2 * x] = wavefront.span[1][2 * x] = stride;
+		wavefront.span[0][2 * x + 1] = wavefront.span[1][2 * x + 1] = -1;
+	}
+
+	for (k = 0; k < goals -> count; k++) {
+
+		wavefront.goal_mask[(size_t)goals -> cells[k].x * stride + (goals -> cells[k].y >> 6)] |= (uint64_t)1 << (goals -> cells[k].y & 63);
+	}
+
+	wavefront.front[0][(size_t)S.x * stride + (S.y >> 6)] = (uint64_t)1 << (S.y & 63);
+	wavefront.visited[(size_t)S.x * stride + (S.y >> 6)] = (uint64_t)1 << (S.y & 63);
+	wavefront.span[0][2 * S.x] = wavefront.span[0][2 * S.x + 1] = S.y >> 6;
+	wavefront.first_row = S.x;
+	wavefront.last_row = S.x;
+	wavefront.distance = 0;
+	wavefront.goal = is_goal(S, goals);
+
+	for (k = 0; k < thread_count; k++) {
+
+		wavefront.jobs[k].wavefront = &wavefront;
+		wavefront.jobs[k].index = k;
+		wavefront.jobs[k].row = (uint64_t *)calloc(2 * stride, sizeof(uint64_t));
+		if (wavefront.jobs[k].row == NULL) {
+
+			printf("[Wavefront] Trouble allocating memory for row buffers.\n");
+			exit(1);
+		}
+	}
+
+	stats -> setup_ns = now_ns() - phase_start;
+	phase_start = now_ns();
+
+	// Each pass runs the rounds one team size fits, the calling thread works the first band itself.
+	while (wavefront.goal == 0 && wavefront.first_row <= wavefront.last_row) {
+
+		wavefront.thread_count = wavefront_team(&wavefront, wavefront.first_row, wavefront.last_row, wavefront.thread_count);
+
+		if (wavefront.thread_count > 1) {
+
+			pthread_barrier_init(&(wavefront.barrier), NULL, wavefront.thread_count);
+		}
+
+		for (k = 1; k < wavefront.thread_count; k++) {
+
+			if (pthread_create(&(threads[k]), NULL, wavefront_worker, &(wavefront.jobs[k])) != 0) {
+
+				printf("[Wavefront] Trouble starting worker %d.\n", k);
+				exit(1);
+			}
+		}
+
+		wavefront_worker(&(wavefront.jobs[0]));
+
+		for (k = 1; k < wavefront.thread_count; k++) {
+
+			pthread_join(threads[k], NULL);
+		}
+
+		if (wavefront.thread_count > 1) {
+
+			pthread_barrier_destroy(&(wavefront.barrier));
+		}
+	}
+
+	stats -> search_ns = now_ns() - phase_start;
+	phase_start = now_ns();
+
+	distance = wavefront.distance;
+	goal = wavefront.goal;
+
+	for (word = 0; word < words; word++) {
+
+		stats -> closed_count += __builtin_popcountll(wavefront.visited[word]);
+	}
+
+	result -> goal = goal;
+	result -> path_cost = (goal != 0) ? distance : -1;
+	result -> expansion_count = (int)stats -> closed_count;
+	result -> node_reuses = 0;
+	stats -> bytes_allocated = 6 * words * sizeof(uint64_t) + thread_count * 2 * stride * sizeof(uint64_t) + 4 * maze_size * sizeof(int);
+
+	if (goal != 0) {
+
+		result -> goal_cell = goals -> cells[goal - 1];
+
+		path = (coordinates_t *)malloc((distance + 1) * sizeof(coordinates_t));
+		if (path == NULL) {
+
+			printf("[Wavefront] Trouble allocating memory for 'path' array.\n");
+			exit(1);
+		}
+
+		// Walk back from the exit, each step to the first reached neighbour holding the previous distance modulo 3.
+		current = result -> goal_cell;
+		path[distance] = current;
+
+		for (k = distance - 1; k >= 0; k--) {
+
+			for (move = 0; move < 8; move++) {
+
+				next.x = current.x + move_x[move];
+				next.y = current.y + move_y[move];
+
+				if (!in_maze(next, maze_size)) {
+
+					continue;
+				}
+
+				word = (size_t)next.x * stride + (next.y >> 6);
+				bit = (uint64_t)1 << (next.y & 63);
+
+				if ((wavefront.visited[word] & bit) && distance_mod_3(wavefront.plane[0], wavefront.plane[1], word, bit) == k % 3) {
+
+					break;
+				}
+			}
+
+			current = next;
+			path[k] = current;
+		}
+	}
+
+	stats -> output_ns = now_ns() - phase_start;
+
+	for (k = 0; k < thread_count; k++) {
+
+		free(wavefront.jobs[k].row);
+	}
+
+	free(wavefront.front[0]);
+	free(wavefront.front[1]);
+	free(wavefront.span[0]);
+	free(wavefront.span[1]);
+	free(wavefront.visited);
+	free(wavefront.plane[0]);
+	free(wavefront.plane[1]);
+	free(wavefront.goal_mask);
+	free(wavefront.jobs);
+	free(threads);
+
+	return path;
+}
+
+void wavefront(maze_t *maze, coordinates_t S, goals_t *goals, int thread_count) {
+
+	search_result_t result;
+	coordinates_t *path = wavefront_search(maze, S, goals, thread_count, &result);
+	long phase_start = now_ns();
+
+	if (path == NULL) {
+
+		print_unreachable(goals);
+	}
+	else {
+
+		printf("Reached G%d[%d][%d].\n", result.goal, result.goal_cell.x, result.goal_cell.y);
+
+		print_path(path, result.path_cost + 1);
+		printf("Cells reached: %d.\n", result.expansion_count);
+
+		free(path);
+	}
+
+	result.stats.output_ns += now_ns() - phase_start;
+	if (show_stats) {
+
+		print_search_stats(&(result.stats));
+	}
+}
+
+// -----------------------------------
+// 			Goal Oracle
+// -----------------------------------
+
+/*	For a maze and exits that don't change, one breadth first flood backward from every exit at once gives
+	each cell its distance to the closest exit and the move that takes it one step closer. A query then needs
+	no search: it reads the distance and follows the moves downhill, in O(route length).
+	Moves are kept as nibbles, two cells per byte.
+*/
+#define ORACLE_AT_GOAL 8		// Next move of an exit.
+#define ORACLE_NO_MOVE 15		// Next move of a cell no exit can be reached from.
+#define ORACLE_UNREACHED UINT32_MAX
+
+typedef struct oracle_s {
+
+	maze_t *maze;			// Must not change while the oracle is in use.
+	goals_t *goals;
+	uint32_t *distance;		// Steps to the closest exit, per cell, ORACLE_UNREACHED if there is none.
+	unsigned char *moves;	// Next move toward that exit, per cell, one nibble each.
+}oracle_t;
+
+int oracle_move(oracle_t *oracle, size_t cell) {
+
+	return (oracle -> moves[cell >> 1] >> ((cell & 1) << 2)) & 0xF;
+}
+
+void set_oracle_move(oracle_t *oracle, size_t cell, int move) {
+
+	oracle -> moves[cell >> 1] = (oracle -> moves[cell >> 1] & ~(0xF << ((cell & 1) << 2))) | (move << ((cell & 1) << 2));
+}
+
+oracle_t *new_oracle(maze_t *maze, goals_t *goals) {
+
+	oracle_t *oracle = NULL;
+	size_t *queue = NULL;
+	size_t cell_count = (size_t)maze -> size * maze -> size, head = 0, tail = 0, cell, next_cell;
+	coordinates_t current, next;
+	int maze_size = maze -> size;
+	int i, move;
+
+	oracle = (oracle_t *)malloc(sizeof(oracle_t));
+	if (oracle == NULL) {
+
+		printf("[Oracle] Trouble allocating memory for the oracle.\n");
+		exit(1);
+	}
+
+	oracle -> maze = maze;
+	oracle -> goals = goals;
+	oracle -> distance = (uint32_t *)malloc(cell_count * sizeof(uint32_t));
+	oracle -> moves = (unsigned char *)malloc((cell_count + 1) / 2);
+	queue = (size_t *)malloc(cell_count * sizeof(size_t));		// Every cell is queued at most once.
+	if (oracle -> distance == NULL || oracle -> moves == NULL || queue == NULL) {
+
+		printf("[Oracle] Trouble allocating memory for the distance field.\n");
+		exit(1);
+	}
+
+	memset(oracle -> distance, 0xFF, cell_count * sizeof(uint32_t));
+	memset(oracle -> moves, (ORACLE_NO_MOVE << 4) | ORACLE_NO_MOVE, (cell_count + 1) / 2);
+
+	// Exits in order, so a cell equally close to two of them leads to the first one, like the searches do.
+	for (i = 0; i < goals -> count; i++) {
+
+		cell = CELL_INDEX(goals -> cells[i], maze_size);
+		if (maze_cell(maze, goals -> cells[i].x, goals -> cells[i].y) && oracle -> distance[cell] == ORACLE_UNREACHED) {
+
+			oracle -> distance[cell] = 0;
+			set_oracle_move(oracle, cell, ORACLE_AT_GOAL);
+			queue[tail++] = cell;
+		}
+	}
+
+	while (head < tail) {
+
+		cell = queue[head++];
+		current.x = (int)(cell / maze_size);
+		current.y = (int)(cell % maze_size);
+
+		for (move = 0; move < 8; move++) {
+
+			next.x = current.x + move_x[move];
+			next.y = current.y + move_y[move];
+
+			if (!in_maze(next, maze_size) || !maze_cell(maze, next.x, next.y)) {
+
+				continue;
+			}
+
+			next_cell = CELL_INDEX(next, maze_size);
+			if (oracle -> distance[next_cell] == ORACLE_UNREACHED) {
+
+				// Moves are symmetric, the way back from 'next' is the opposite move.
+				oracle -> distance[next_cell] = oracle -> distance[cell] + 1;
+				set_oracle_move(oracle, next_cell, (move + 4) & 7);
+				queue[tail++] = next_cell;
+			}
+		}
+	}
+
+	free(queue);
+
+	return oracle;
+}
+
+void free_oracle(oracle_t *oracle) {
+
+	free(oracle -> distance);
+	free(oracle -> moves);
+	free(oracle);
+}
+
+int oracle_distance(oracle_t *oracle, coordinates_t S) {	// Steps from S to the closest exit, -1 if none can be reached.
+
+	uint32_t distance = oracle -> distance[CELL_INDEX(S, oracle -> maze -> size)];
+
+	return (distance == ORACLE_UNREACHED) ? -1 : (int)distance;
+}
+
+coordinates_t *oracle_search(oracle_t *oracle, coordinates_t S, search_result_t *result) {
+
+	/*	Same answer as a UCS query from S, without searching: the route follows the stored moves downhill.
+		Returns the route, or NULL if no exit can be reached.
+	*/
+	coordinates_t *path = NULL;
+	int maze_size = oracle -> maze -> size;
+	int path_cost, step, move;
+	long phase_start = now_ns();
+
+	memset(&(result -> stats), 0, sizeof(search_stats_t));
+
+	path_cost = oracle_distance(oracle, S);
+	if (path_cost < 0) {
+
+		set_unreachable(result);
+		return NULL;
+	}
+
+	path = (coordinates_t *)malloc((path_cost + 1) * sizeof(coordinates_t));
+	if (path == NULL) {
+
+		printf("[Oracle] Trouble allocating memory for 'path' array.\n");
+		exit(1);
+	}
+
+	path[0] = S;
+	for (step = 1; step <= path_cost; step++) {
+
+		move = oracle_move(oracle, CELL_INDEX(path[step - 1], maze_size));
+		path[step].x = path[step - 1].x + move_x[move];
+		path[step].y = path[step - 1].y + move_y[move];
+	}
+
+	result -> goal_cell = path[path_cost];
+	result -> goal = is_goal(result -> goal_cell, oracle -> goals);
+	result -> path_cost = path_cost;
+	result -> expansion_count = 0;
+	result -> node_reuses = 0;
+	result -> stats.output_ns = now_ns() - phase_start;
+
+	return path;
+}
+
+void goal_oracle(oracle_t *oracle, coordinates_t S) {
+
+	search_result_t result;
+	coordinates_t *path = oracle_search(oracle, S, &result);
+
+	if (path == NULL) {
+
+		print_unreachable(oracle -> goals);
+		return;
+	}
+
+	printf("Reached G%d[%d][%d].\n", result.goal, result.goal_cell.x, result.goal_cell.y);
+
+	print_path(path, result.path_cost + 1);
+	printf("Number of expansions: %d.\n", result.expansion_count);
+
+	free(path);
+}
+
+// -----------------------------------
+// 			Path Database
+// -----------------------------------
+
+/*	Compressed path database, for many queries between arbitrary cells of a maze that doesn't change.
+	For every free source cell, a breadth first flood gives the first move of an optimal route to every
+	other cell. Listed in row major order those moves come in long runs, so each source keeps only its runs,
+	each the index of its first cell and the move. Obstacles and cells the source can't reach fit any run,
+	so they never start a new one. A query looks up the first move from the current cell to the target,
+	takes it and repeats, so a route costs one binary search per step and no search at all.
+
+	Database file: a cpd_file_header_t, then cell_count + 1 run offsets (uint64) and run_count runs (uint32).
+*/
+#define CPD_FILE_MAGIC "MAZECPD1"
+#define CPD_RUN(first_cell, move) ((uint32_t)(first_cell) << 3 | (uint32_t)(move))
+#define CPD_RUN_CELL(run) ((run) >> 3)
+#define CPD_RUN_MOVE(run) ((int)((run) & 7))
+#define CPD_MAX_CELLS ((size_t)1 << 29)		// A run's first cell has 29 bits.
+
+typedef struct cpd_s {
+
+	maze_t *maze;			// Must not change while the database is in use.
+	size_t cell_count;
+	uint64_t *offsets;		// Runs of source cell i are runs[offsets[i]] to runs[offsets[i + 1] - 1].
+	uint32_t *runs;			// CPD_RUN(first cell, first move), by source, then by first cell.
+	uint64_t run_count;
+	void *mapping;			// Database file 'offsets' and 'runs' point into, NULL if they were allocated.
+	size_t mapping_length;
+}cpd_t;
+
+typedef struct cpd_file_header_s {
+
+	char magic[8];			// CPD_FILE_MAGIC, without the terminating '\0'.
+	int32_t size;
+	int32_t padding;
+	uint64_t maze_hash;		// maze_hash() of the maze the database was built for.
+	uint64_t run_count;
+}cpd_file_header_t;
+
+typedef struct cpd_build_s {
+
+	cpd_t *cpd;
+	uint32_t **source_runs;	// Runs of every source, until they are packed into one array.
+	size_t next_source;		// Next source to hand out, taken atomically by the workers.
+}cpd_build_t;
+
+uint64_t maze_hash(maze_t *maze) {	// FNV-1a over the rows, to tell whether a database belongs to a maze.
+
+	uint64_t hash = 0xCBF29CE484222325ULL;
+	size_t w, words = (size_t)maze -> size * maze -> stride;
+
+	for (w = 0; w < words; w++) {
+
+		hash = (hash ^ maze -> cells[w]) * 0x100000001B3ULL;
+	}
+
+	return hash;
+}
+
+void *cpd_worker(void *argument) {
+
+	/*	Takes sources one at a time. For each, floods the maze remembering the first move every cell was
+		reached by, then compresses those moves into runs over the cells in row major order.
+	*/
+	cpd_build_t *build = (cpd_build_t *)argument;
+	maze_t *maze = build -> cpd -> maze;
+	size_t cell_count = build -> cpd -> cell_count, source, cell, next_cell, head, tail;
+	uint32_t *queue = NULL, *seen = NULL, *runs = NULL;
+	unsigned char *first_move = NULL;
+	coordinates_t current, next;
+	int maze_size = maze -> size, move, run_move;
+	size_t run_count, run_capacity = 64;
+
+	queue = (uint32_t *)malloc(cell_count * sizeof(uint32_t));
+	seen = (uint32_t *)calloc(cell_count, sizeof(uint32_t));		// Source + 1 once a cell is reached from that source.
+	first_move = (unsigned char *)malloc(cell_count);
+	runs = (uint32_t *)malloc(run_capacity * sizeof(uint32_t));
+	if (queue == NULL || seen == NULL || first_move == NULL || runs == NULL) {
+
+		printf("[Path database] Trouble allocating memory for a worker.\n");
+		exit(1);
+	}
+
+	while ((source = __atomic_fetch_add(&(build -> next_source), 1, __ATOMIC_RELAXED)) < cell_count) {
+
+		current.x = (int)(source / maze_size);
+		current.y = (int)(source % maze_size);
+		if (!maze_cell(maze, current.x, current.y)) {
+
+			build -> source_runs[source] = NULL;
+			continue;
+		}
+
+		head = 0;
+		tail = 0;
+		seen[source] = (uint32_t)source + 1;
+		queue[tail++] = (uint32_t)source;
+
+		while (head < tail) {
+
+			cell = queue[head++];
+			current.x = (int)(cell / maze_size);
+			current.y = (int)(cell % maze_size);
+
+			for (move = 0; move < 8; move++) {
+
+				next.x = current.x + move_x[move];
+				next.y = current.y + move_y[move];
+
+				if (!in_maze(next, maze_size) || !maze_cell(maze, next.x, next.y)) {
+
+					continue;
+				}
+
+				next_cell = CELL_INDEX(next, maze_size);
+				if (seen[next_cell] != (uint32_t)source + 1) {
+
+					seen[next_cell] = (uint32_t)source + 1;
+					first_move[next_cell] = (cell == source) ? move : first_move[cell];
+					queue[tail++] = (uint32_t)next_cell;
+				}
+			}
+		}
+
+		// A run starts where the move changes. Cells without a move (walls, unreached, the source itself) extend the current run.
+		run_count = 0;
+		run_move = -1;
+		for (cell = 0; cell < cell_count; cell++) {
+
+			if (seen[cell] != (uint32_t)source + 1 || cell == source || first_move[cell] == run_move) {
+
+				continue;
+			}
+
+			if (run_count == run_capacity) {
+
+				run_capacity *= 2;
+				runs = (uint32_t *)realloc(runs, run_capacity * sizeof(uint32_t));
+				if (runs == NULL) {
+
+					printf("[Path database] Trouble allocating memory for runs.\n");
+					exit(1);
+				}
+			}
+
+			run_move = first_move[cell];
+			runs[run_count++] = CPD_RUN(cell, run_move);
+		}
+
+		// The first run covers the cells before it as well, it starts at cell 0.
+		if (run_count > 0) {
+
+			runs[0] = CPD_RUN(0, CPD_RUN_MOVE(runs[0]));
+		}
+
+		build -> source_runs[source] = (uint32_t *)malloc((run_count + 1) * sizeof(uint32_t));
+		if (build -> source_runs[source] == NULL) {
+
+			printf("[Path database] Trouble allocating memory for runs.\n");
+			exit(1);
+		}
+
+		build -> source_runs[source][0] = (uint32_t)run_count;
+		memcpy(build -> source_runs[source] + 1, runs, run_count * sizeof(uint32_t));
+	}
+
+	free(queue);
+	free(seen);
+	free(first_move);
+	free(runs);
+
+	return NULL;
+}
+
+cpd_t *new_cpd(maze_t *maze, int thread_count) {
+
+	/*	Builds the database on 'thread_count' workers. Each source is a full flood of the maze, so building
+		takes time in the square of the cell count: meant to be done once, offline, and kept with save_cpd().
+	*/
+	cpd_t *cpd = NULL;
+	cpd_build_t build;
+	pthread_t *threads = NULL;
+	size_t cell_count = (size_t)maze -> size * maze -> size, source;
+	uint32_t run_count;
+	int i;
+
+	if (cell_count > CPD_MAX_CELLS) {
+
+		printf("[Path database] The maze is too large for a path database.\n");
+		exit(1);
+	}
+
+	if (thread_count < 1) {
+
+		thread_count = 1;
+	}
+
+	if (maze -> component == NULL) {
+
+		label_components(maze);
+	}
+
+	cpd = (cpd_t *)malloc(sizeof(cpd_t));
+	build.source_runs = (uint32_t **)malloc(cell_count * sizeof(uint32_t *));
+	threads = (pthread_t *)malloc(thread_count * sizeof(pthread_t));
+	if (cpd == NULL || build.source_runs == NULL || threads == NULL) {
+
+		printf("[Path database] Trouble allocating memory for the database.\n");
+		exit(1);
+	}
+
+	cpd -> maze = maze;
+	cpd -> cell_count = cell_count;
+	cpd -> mapping = NULL;
+	cpd -> mapping_length = 0;
+	build.cpd = cpd;
+	build.next_source = 0;
+
+	for (i = 0; i < thread_count; i++) {
+
+		if (pthread_create(&(threads[i]), NULL, cpd_worker, &build) != 0) {
+
+			printf("[Path database] Trouble starting worker %d.\n", i);
+			exit(1);
+		}
+	}
+
+	for (i = 0; i < thread_count; i++) {
+
+		pthread_join(threads[i], NULL);
+	}
+
+	// Pack every source's runs into one array, in source order.
+	cpd -> offsets = (uint64_t *)malloc((cell_count + 1) * sizeof(uint64_t));
+	if (cpd -> offsets == NULL) {
+
+		printf("[Path database] Trouble allocating memory for the database.\n");
+		exit(1);
+	}
+
+	cpd -> run_count = 0;
+	for (source = 0; source < cell_count; source++) {
+
+		cpd -> offsets[source] = cpd -> run_count;
+		cpd -> run_count += (build.source_runs[source] != NULL) ? build.source_runs[source][0] : 0;
+	}
+	cpd -> offsets[cell_count] = cpd -> run_count;
+
+	cpd -> runs = (uint32_t *)malloc((cpd -> run_count + 1) * sizeof(uint32_t));
+	if (cpd -> runs == NULL) {
+
+		printf("[Path database] Trouble allocating memory for the database.\n");
+		exit(1);
+	}
+
+	for (source = 0; source < cell_count; source++) {
+
+		if (build.source_runs[source] != NULL) {
+
+			run_count = build.source_runs[source][0];
+			memcpy(cpd -> runs + cpd -> offsets[source], build.source_runs[source] + 1, run_count * sizeof(uint32_t));
+			free(build.source_runs[source]);
+		}
+	}
+
+	free(build.source_runs);
+	free(threads);
+
+	return cpd;
+}
+
+void free_cpd(cpd_t *cpd) {
+
+	if (cpd -> mapping != NULL) {
+
+		munmap(cpd -> mapping, cpd -> mapping_length);
+	}
+	else {
+
+		free(cpd -> offsets);
+		free(cpd -> runs);
+	}
+
+	free(cpd);
+}
+
+void save_cpd(cpd_t *cpd, char *file_name) {
+
+	cpd_file_header_t header;
+	FILE *file = NULL;
+
+	memcpy(header.magic, CPD_FILE_MAGIC, sizeof(header.magic));
+	header.size = cpd -> maze -> size;
+	header.padding = 0;
+	header.maze_hash = maze_hash(cpd -> maze);
+	header.run_count = cpd -> run_count;
+
+	file = fopen(file_name, "wb");
+	if (file == NULL) {
+
+		printf("Trouble opening path database file %s.\n", file_name);
+		exit(1);
+	}
+
+	if (fwrite(&header, sizeof(header), 1, file) != 1
+		|| fwrite(cpd -> offsets, sizeof(uint64_t), cpd -> cell_count + 1, file) != cpd -> cell_count + 1
+		|| fwrite(cpd -> runs, sizeof(uint32_t), cpd -> run_count, file) != cpd -> run_count
+		|| fclose(file) != 0) {
+
+		printf("Trouble writing path database file %s.\n", file_name);
+		exit(1);
+	}
+}
+
+cpd_t *load_cpd(maze_t *maze, char *file_name) {
+
+	/*	Maps a file written by save_cpd() for this very maze. Returns NULL if the file can't be opened,
+		so the caller can build the database instead, exits if it belongs to another maze.
+	*/
+	cpd_file_header_t *header = NULL;
+	cpd_t *cpd = NULL;
+	struct stat file_stat;
+	size_t cell_count = (size_t)maze -> size * maze -> size;
+	void *mapping = NULL;
+	int file;
+
+	file = open(file_name, O_RDONLY);
+	if (file < 0) {
+
+		return NULL;
+	}
+
+	if (fstat(file, &file_stat) != 0 || (size_t)file_stat.st_size < sizeof(cpd_file_header_t)) {
+
+		printf("%s is not a path database file.\n", file_name);
+		exit(1);
+	}
+
+	mapping = mmap(NULL, file_stat.st_size, PROT_READ, MAP_PRIVATE, file, 0);
+	close(file);
+	if (mapping == MAP_FAILED) {
+
+		printf("Trouble mapping path database file %s.\n", file_name);
+		exit(1);
+	}
+
+	header = (cpd_file_header_t *)mapping;
+	if (memcmp(header -> magic, CPD_FILE_MAGIC, sizeof(header -> magic)) != 0
+		|| sizeof(cpd_file_header_t) + (cell_count + 1) * sizeof(uint64_t) + header -> run_count * sizeof(uint32_t) != (uint64_t)file_stat.st_size) {
+
+		printf("%s is not a path database file.\n", file_name);
+		exit(1);
+	}
+
+	if (header -> size != maze -> size || header -> maze_hash != maze_hash(maze)) {
+
+		printf("%s was built for another maze.\n", file_name);
+		exit(1);
+	}
+
+	cpd = (cpd_t *)malloc(sizeof(cpd_t));
+	if (cpd == NULL) {
+
+		printf("Trouble allocating memory for path database.\n");
+		exit(1);
+	}
+
+	if (maze -> component == NULL) {
+
+		label_components(maze);
+	}
+
+	cpd -> maze = maze;
+	cpd -> cell_count = cell_count;
+	cpd -> offsets = (uint64_t *)((char *)mapping + sizeof(cpd_file_header_t));
+	cpd -> runs = (uint32_t *)(cpd -> offsets + cell_count + 1);
+	cpd -> run_count = header -> run_count;
+	cpd -> mapping = mapping;
+	cpd -> mapping_length = file_stat.st_size;
+
+	return cpd;
+}
+
+int cpd_first_move(cpd_t *cpd, size_t source, size_t target) {	// First move of an optimal route, the last run starting at or before 'target'.
+
+	uint64_t low = cpd -> offsets[source], high = cpd -> offsets[source + 1] - 1, middle;
+
+	while (low < high) {
+
+		middle = low + (high - low + 1) / 2;
+		if (CPD_RUN_CELL(cpd -> runs[middle]) <= target) {
+
+			low = middle;
+		}
+		else {
+
+			high = middle - 1;
+		}
+	}
+
+	return CPD_RUN_MOVE(cpd -> runs[low]);
+}
+
+int cpd_walk(cpd_t *cpd, coordinates_t from, coordinates_t to, coordinates_t *path) {
+
+	/*	Follows the first moves from 'from' to 'to', storing the cells in 'path' unless it's NULL.
+		Returns the route's cost, -1 if 'to' can't be reached.
+	*/
+	int maze_size = cpd -> maze -> size;
+	int steps = 0, move;
+	uint32_t component = cpd -> maze -> component[CELL_INDEX(from, maze_size)];
+
+	if (component == 0 || component != cpd -> maze -> component[CELL_INDEX(to, maze_size)]) {
+
+		return (from.x == to.x && from.y == to.y) ? 0 : -1;
+	}
+
+	if (path != NULL) {
+
+		path[0] = from;
+	}
+
+	while (from.x != to.x || from.y != to.y) {
+
+		move = cpd_first_move(cpd, CELL_INDEX(from, maze_size), CELL_INDEX(to, maze_size));
+		from.x += move_x[move];
+		from.y += move_y[move];
+
+		steps++;
+		if (path != NULL) {
+
+			path[steps] = from;
+		}
+	}
+
+	return steps;
+}
+
+coordinates_t *cpd_search(cpd_t *cpd, coordinates_t S, goals_t *goals, search_result_t *result) {
+
+	/*	Same answer as a_star(): the route to the closest exit, measured by walking the database to each exit.
+		Returns the route, or NULL if no exit can be reached.
+	*/
+	coordinates_t *path = NULL;
+	int i, cost;
+	long phase_start = now_ns();
+
+	set_unreachable(result);
+
+	for (i = 0; i < goals -> count; i++) {
+
+		cost = cpd_walk(cpd, S, goals -> cells[i], NULL);
+		if (cost >= 0 && (result -> goal == 0 || cost < result -> path_cost)) {
+
+			result -> goal = i + 1;
+			result -> goal_cell = goals -> cells[i];
+			result -> path_cost = cost;
+		}
+	}
+
+	result -> stats.search_ns = now_ns() - phase_start;
+	phase_start = now_ns();
+
+	if (result -> goal != 0) {
+
+		path = (coordinates_t *)malloc((result -> path_cost + 1) * sizeof(coordinates_t));
+		if (path == NULL) {
+
+			printf("[Path database] Trouble allocating memory for 'path' array.\n");
+			exit(1);
+		}
+
+		cpd_walk(cpd, S, result -> goal_cell, path);
+	}
+
+	result -> stats.output_ns = now_ns() - phase_start;
+
+	return path;
+}
+
+void path_database(cpd_t *cpd, coordinates_t S, goals_t *goals) {
+
+	search_result_t result;
+	coordinates_t *path = cpd_search(cpd, S, goals, &result);
+
+	if (path == NULL) {
+
+		print_unreachable(goals);
+		return;
+	}
+
+	printf("Reached G%d[%d][%d].\n", result.goal, result.goal_cell.x, result.goal_cell.y);
+
+	print_path(path, result.path_cost + 1);
+	printf("Number of expansions: %d.\n", result.expansion_count);
+
+	free(path);
+}
+
+// -----------------------------------
+// 			Batch Queries
+// -----------------------------------
+
+typedef struct batch_s {
+
+	maze_t *maze;			// Shared by every worker, read only.
+	query_t *queries;
+	int query_count;
+	int use_heuristic;
+	int frontier_type;
+	int next_query;			// Next query to hand out, taken atomically by the workers.
+}batch_t;
+
+void *batch_worker(void *argument) {
+
+	batch_t *batch = (batch_t *)argument;
+	workspace_t *workspace = new_workspace(batch -> frontier_type, batch -> maze -> size);
+	query_t *query = NULL;
+	int i;
+
+	// One workspace per worker, reused by every query the worker takes.
+	while ((i = __atomic_fetch_add(&(batch -> next_query), 1, __ATOMIC_RELAXED)) < batch -> query_count) {
+
+		query = &(batch -> queries[i]);
+		best_first(workspace, batch -> maze, query -> S, query -> goals, batch -> use_heuristic, &(query -> result));
+	}
+
+	free_workspace(workspace);
+	return NULL;
+}
+
+void solve_batch(maze_t *maze, query_t *queries, int query_count, int thread_count, int use_heuristic, int frontier_type) {
+
+	/*	Answers every query (route cost, exit reached and expansions, no path) on 'thread_count' workers.
+		Queries are handed out one at a time, so a few long ones don't hold up a whole thread's share.
+	*/
+	pthread_t *threads = NULL;
+	batch_t batch;
+	int i;
+
+	if (thread_count < 1) {
+
+		thread_count = 1;
+	}
+
+	batch.maze = maze;
+	batch.queries = queries;
+	batch.query_count = query_count;
+	batch.use_heuristic = use_heuristic;
+	batch.frontier_type = frontier_type;
+	batch.next_query = 0;
+
+	threads = (pthread_t *)malloc(thread_count * sizeof(pthread_t));
+	if (threads == NULL) {
+
+		printf("Trouble allocating memory for batch workers.\n");
+		exit(1);
+	}
+
+	for (i = 0; i < thread_count; i++) {
+
+		if (pthread_create(&(threads[i]), NULL, batch_worker, &batch) != 0) {
+
+			printf("Trouble starting batch worker %d.\n", i);
+			exit(1);
+		}
+	}
+
+	for (i = 0; i < thread_count; i++) {
+
+		pthread_join(threads[i], NULL);
+	}
+
+	free(threads);
+}
+
+void solve_interleaved(maze_t *maze, query_t *queries, int query_count, int slot_count, int max_expansions, int use_heuristic, int frontier_type) {
+
+	/*	Answers every query like solve_batch(), but on the calling thread: up to 'slot_count' searches are open at once
+		and take turns expanding 'max_expansions' cells each, so a hard query never holds up the others for long.
+	*/
+	search_t *searches = NULL;
+	workspace_t **workspaces = NULL;
+	int *slot_query = NULL;		// Query each slot is answering, -1 once there are none left to start.
+	int i, next_query = 0, open_count = 0;
+
+	if (slot_count < 1) {
+
+		slot_count = 1;
+	}
+
+	searches = (search_t *)malloc(slot_count * sizeof(search_t));
+	workspaces = (workspace_t **)malloc(slot_count * sizeof(workspace_t *));
+	slot_query = (int *)malloc(slot_count * sizeof(int));
+	if (searches == NULL || workspaces == NULL || slot_query == NULL) {
+
+		printf("Trouble allocating memory for interleaved queries.\n");
+		exit(1);
+	}
+
+	for (i = 0; i < slot_count; i++) {
+
+		workspaces[i] = new_workspace(frontier_type, maze -> size);
+		slot_query[i] = -1;
+		if (next_query < query_count) {
+
+			slot_query[i] = next_query++;
+			search_begin(&(searches[i]), workspaces[i], maze, queries[slot_query[i]].S, queries[slot_query[i]].goals, use_heuristic ? 1.0 : 0.0);
+			open_count++;
+		}
+	}
+
+	while (open_count > 0) {
+
+		for (i = 0; i < slot_count; i++) {
+
+			if (slot_query[i] == -1 || !search_step(&(searches[i]), max_expansions)) {
 
-		while (i_index >= 0) {
+				continue;
+			}
+
+			// Done, the slot's workspace moves on to the next query.
+			queries[slot_query[i]].result = *search_result(&(searches[i]));
+			slot_query[i] = -1;
+			open_count--;
 
-			if (maze[i_index][j_index] == 1) {
+			if (next_query < query_count) {
 
-				(cell_priority[i_index][j_index]) = cost;
+				slot_query[i] = next_query++;
+				search_begin(&(searches[i]), workspaces[i], maze, queries[slot_query[i]].S, queries[slot_query[i]].goals, use_heuristic ? 1.0 : 0.0);
+				open_count++;
 			}
-			cost++;
-			i_index--;
 		}
 	}
 
-	if (S.x != maze_size) {		// Down.
+	for (i = 0; i < slot_count; i++) {
 
-		i_index = S.x + 1;
-		j_index = S.y;
-		cost = 1;
+		free_workspace(workspaces[i]);
+	}
 
-		while (i_index < maze_size) {
+	free(searches);
+	free(workspaces);
+	free(slot_query);
+}
+
+// -----------------------------------
+// 				Tests
+// -----------------------------------
 
-			if (maze[i_index][j_index] == 1) {
+void test_visited() {
 
-				(cell_priority[i_index][j_index]) = cost;
-			}
-			cost++;
-			i_index++;
-		}
+	uint64_t *visited = NULL;
+	coordinates_t current_coordinates;
+	int i;
+
+	visited = new_bitset(5 * 5);
+
+	for (i = 1; i < 5; i++) {
+
+		current_coordinates.x = i;
+		current_coordinates.y = i;
+		push_visited(current_coordinates, visited, 5);
 	}
 
-	if (S.y != 0) {		// Left.
+	for (i = 0; i < 5; i++) {
 
-		i_index = S.x;
-		j_index = S.y - 1;
-		cost = 1;
+		current_coordinates.x = i;
+		current_coordinates.y = i;
+		printf("visited[%d][%d] = %d\n", i, i, is_visited(current_coordinates, visited, 5));
+	}
 
-		while (j_index >= 0) {
+	current_coordinates.x = 3;
+	current_coordinates.y = 3;
 
-			if (maze[i_index][j_index] == 1) {
+	if (is_visited(current_coordinates, visited, 5)) {
 
-				(cell_priority[i_index][j_index]) = cost;
-			}
-			cost++;
-			j_index--;
-		}
+		printf("[%d][%d] is visited.\n", current_coordinates.x, current_coordinates.y);
 	}
+	else {
 
-	if (S.y != maze_size) {		// Right.
+		printf("[%d][%d] is not visited.\n", current_coordinates.x, current_coordinates.y);
+	}
 
-		i_index = S.x;
-		j_index = S.y + 1;
-		cost = 1;
+	free(visited);
+}
 
-		while (j_index < maze_size) {
+void test_push_visited() {
+
+	uint64_t *visited = NULL;
+	coordinates_t new_coordinates;
+	int i, j;
 
-			if (maze[i_index][j_index] == 1) {
+	visited = new_bitset(10 * 10);
 
-				(cell_priority[i_index][j_index]) = cost;
+	new_coordinates.x = 5;
+	new_coordinates.y = 5;
+
+	push_visited(new_coordinates, visited, 10);
+
+	for (i = 0; i < 10; i++) {
+		for (j = 0; j < 10; j++) {
+
+			new_coordinates.x = i;
+			new_coordinates.y = j;
+			if (is_visited(new_coordinates, visited, 10)) {
+
+				printf("Visited [%d][%d]\n", i, j);
 			}
-			cost++;
-			j_index++;
 		}
 	}
 
-	for (i_index = 0; i_index < S.x; i_index++) {					// Upper right quarter.
-		for (j_index = S.y + 1; j_index < maze_size; j_index++) {
+	free(visited);
+}
 
-			if (maze[i_index][j_index] == 1 && cell_priority[i_index][j_index] == 0) {
+void test_queue(coordinates_t S) {
 
-				min_neighboring_cost = find_min(maze, cell_priority, maze_size, i_index, j_index);
-				cell_priority[i_index][j_index] = min_neighboring_cost + 1;
-				//printf("Assigning cell_priority[%d][%d] to %d.\n", i_index, j_index, cell_priority[i_index][j_index]);
-			}
-		}
+	frontier_t *search_frontier = NULL;
+	int i, priority = 1;
+
+	search_frontier = new_frontier(FRONTIER_QUATERNARY_HEAP, 10);
+	push(search_frontier, S, priority);
+
+	for (i = 0; i < 5; i++) {
+
+		S.x++;
+		S.y++;
+		priority++;
+
+		push(search_frontier, S, priority);
 	}
 
-	for (i_index = 0; i_index < S.x; i_index++) {					// Upper left quarter.
-		for (j_index = S.y - 1; j_index >= 0; j_index--) {
+	print_frontier(search_frontier);
 
-			if (maze[i_index][j_index] == 1 && cell_priority[i_index][j_index] == 0) {
+	for (i = 0; i < 4; i++) {
 
-				min_neighboring_cost = find_min(maze, cell_priority, maze_size, i_index, j_index);
-				cell_priority[i_index][j_index] = min_neighboring_cost + 1;
-				//printf("Assigning cell_priority[%d][%d] to %d.\n", i_index, j_index, cell_priority[i_index][j_index]);
-			}
+		pop(search_frontier);
+
+		print_frontier(search_frontier);
+	}
+
+	free_frontier(search_frontier);
+}
+
+void test_bucket_queue(coordinates_t S) {
+
+	frontier_t *search_frontier = NULL;
+	int priorities[6] = {3, 1, 4, 1, 5, 2};
+	int i;
+
+	search_frontier = new_frontier(FRONTIER_BUCKET_QUEUE, 10);
+
+	for (i = 0; i < 6; i++) {
+
+		S.x++;
+		S.y++;
+
+		push(search_frontier, S, priorities[i]);
+	}
+
+	print_frontier(search_frontier);
+
+	while (!is_empty(search_frontier)) {
+
+		printf("Popping [%d][%d]\n", peek(search_frontier).x, peek(search_frontier).y);
+		pop(search_frontier);
+	}
+
+	free_frontier(search_frontier);
+}
+
+void test_check_frontier(coordinates_t S) {
+
+	frontier_t *search_frontier = NULL;
+	coordinates_t current_coordinates;
+	int i, priority = 1;
+
+	search_frontier = new_frontier(FRONTIER_QUATERNARY_HEAP, 10);
+	push(search_frontier, S, priority);
+
+	for (i = 0; i < 5; i++) {
+
+		S.x++;
+		S.y++;
+		priority++;
+
+		push(search_frontier, S, priority);
+	}
+
+	print_frontier(search_frontier);
+
+	current_coordinates.x = 3;
+	current_coordinates.y = 3;
+
+	check_frontier(search_frontier, current_coordinates);
+
+	free_frontier(search_frontier);
+}
+
+void test_assign_cost(maze_t *maze, coordinates_t S) {
+
+	int *cell_priority = NULL;
+	int i, j, maze_size = maze -> size;
+
+	cell_priority = assign_cost(maze, S);
+
+	printf("\n");
+
+	for (i = 0; i < maze_size; i++) {
+		for (j = 0; j < maze_size; j++) {
+
+			printf("%d ", cell_priority[i * maze_size + j]);
 		}
+		printf("\n");
 	}
 
-	for (i_index = S.x + 1; i_index < maze_size; i_index++) {		// Bottom right quarter.
-		for (j_index = S.y + 1; j_index < maze_size; j_index++) {
+	printf("\n");
+
+	free(cell_priority);
+}
+
+void test_nearest_goal_field() {
+
+	coordinates_t goal_cells[GOAL_FIELD_THRESHOLD + 1];
+	coordinates_t current_coordinates;
+	goals_t *goals = NULL;
+	int i, h, mismatches = 0;
+
+	for (i = 0; i <= GOAL_FIELD_THRESHOLD; i++) {
 
-			if (maze[i_index][j_index] == 1 && cell_priority[i_index][j_index] == 0) {
+		goal_cells[i].x = (i * 7) % 20;
+		goal_cells[i].y = (i * 13) % 20;
+	}
+
+	goals = new_goals(goal_cells, GOAL_FIELD_THRESHOLD + 1, 20);
+
+	for (current_coordinates.x = 0; current_coordinates.x < 20; current_coordinates.x++) {
+		for (current_coordinates.y = 0; current_coordinates.y < 20; current_coordinates.y++) {
+
+			h = heuristic(current_coordinates, goal_cells[0]);
+			for (i = 1; i <= GOAL_FIELD_THRESHOLD; i++) {
 
-				min_neighboring_cost = find_min(maze, cell_priority, maze_size, i_index, j_index);
-				cell_priority[i_index][j_index] = min_neighboring_cost + 1;
-				//printf("Assigning cell_priority[%d][%d] to %d.\n", i_index, j_index, cell_priority[i_index][j_index]);
+				h = min_heuristic(h, heuristic(current_coordinates, goal_cells[i]));
+			}
+
+			if (h != goal_heuristic(current_coordinates, goals)) {
+
+				mismatches++;
 			}
 		}
 	}
 
-	for (i_index = S.x + 1; i_index < maze_size; i_index++) {		// Bottom left quarter.
-		for (j_index = S.y - 1; j_index >= 0; j_index--) {
+	printf("Nearest exit field mismatches: %d\n", mismatches);
+
+	free_goals(goals);
+}
+
+void test_solve_batch(maze_t *maze, int frontier_type) {
+
+	/*	Every free cell asks for its way out to the opposite corner, on 4 workers and then on 1.
+		Both runs must agree on each query.
+	*/
+	coordinates_t corner;
+	query_t *queries = NULL, *serial = NULL;
+	goals_t *goals = NULL;
+	int maze_size = maze -> size;
+	int i, x, y, query_count = 0, mismatches = 0;
+
+	corner.x = maze_size - 1;
+	corner.y = maze_size - 1;
+	goals = new_goals(&corner, 1, maze_size);
+
+	queries = (query_t *)malloc((size_t)maze_size * maze_size * sizeof(query_t));
+	serial = (query_t *)malloc((size_t)maze_size * maze_size * sizeof(query_t));
+	if (queries == NULL || serial == NULL) {
 
-			if (maze[i_index][j_index] == 1 && cell_priority[i_index][j_index] == 0) {
+		printf("Trouble allocating memory for queries.\n");
+		exit(1);
+	}
+
+	for (x = 0; x < maze_size; x++) {
+		for (y = 0; y < maze_size; y++) {
+
+			if (maze_cell(maze, x, y) != 0) {
 
-				min_neighboring_cost = find_min(maze, cell_priority, maze_size, i_index, j_index);
-				cell_priority[i_index][j_index] = min_neighboring_cost + 1;
-				//printf("Assigning cell_priority[%d][%d] to %d.\n", i_index, j_index, cell_priority[i_index][j_index]);
+				queries[query_count].S.x = x;
+				queries[query_count].S.y = y;
+				queries[query_count].goals = goals;
+				query_count++;
 			}
-		}		
+		}
 	}
-	/*
-	printf("Cell Priority:\n");
 
-	for (i_index = 0; i_index < maze_size; i_index++) {
-		for (j_index = 0; j_index < maze_size; j_index++) {
+	memcpy(serial, queries, query_count * sizeof(query_t));
+
+	solve_batch(maze, queries, query_count, 4, 1, frontier_type);
+	solve_batch(maze, serial, query_count, 1, 1, frontier_type);
+
+	for (i = 0; i < query_count; i++) {
 
-			printf("%d ", cell_priority[i_index][j_index]);
+		if (queries[i].result.goal != serial[i].result.goal || queries[i].result.path_cost != serial[i].result.path_cost) {
+
+			mismatches++;
 		}
-		printf("\n");
 	}
-	*/
-	return cell_priority;
+
+	printf("Batch queries: %d, mismatches between 4 and 1 workers: %d\n", query_count, mismatches);
+
+	free(queries);
+	free(serial);
+	free_goals(goals);
 }
 
-// -----------------------------------
-// 	  UCS, A* utility functions
-// -----------------------------------
+void test_maze_layout_reproducible() {
 
-void print_frontier(node_t **search_frontier) {
+	coordinates_t S, G;
+	goals_t *goals = NULL;
+	maze_t *serial = NULL, *parallel = NULL;
+	int maze_size = 300;
 
-	node_t *head = (*search_frontier);
+	S.x = S.y = 0;
+	G.x = G.y = maze_size - 1;
+	goals = new_goals(&G, 1, maze_size);
 
-	printf("Search Frontier: \n");
-	while (head -> next != NULL) {
+	serial = create_maze(maze_size);
+	parallel = create_maze(maze_size);
 
-		printf("[Priority: %d] [%d][%d]\n", head -> priority, (head -> cell).x, (head -> cell).y);
-		head = head -> next;
-	}
+	set_maze_layout(serial, 0.7, 42, 1, S, goals);
+	set_maze_layout(parallel, 0.7, 42, 7, S, goals);
+
+	printf("Same maze on 1 and 7 threads: %s\n", memcmp(serial -> cells, parallel -> cells, (size_t)maze_size * serial -> stride * sizeof(uint64_t)) == 0 ? "yes" : "no");
 
-	//printf("[Priority: %d] [%d][%d]\n", head -> priority, (head -> cell).x, (head -> cell).y);
+	free_maze(serial);
+	free_maze(parallel);
+	free_goals(goals);
 }
 
-int check_frontier(node_t **search_frontier, coordinates_t current_coordinates) {
+void test_maze_file() {
 
-	node_t *head = (*search_frontier);
+	coordinates_t S, loaded_S, goal_cells[2];
+	coordinates_t *loaded_goal_cells = NULL;
+	goals_t *goals = NULL;
+	maze_t *maze = NULL, *loaded = NULL;
+	int maze_size = 130, loaded_goal_count;
 
-	while (head -> next != NULL) {
+	S.x = S.y = 0;
+	goal_cells[0].x = goal_cells[0].y = maze_size - 1;
+	goal_cells[1].x = 3;
+	goal_cells[1].y = 100;
+	goals = new_goals(goal_cells, 2, maze_size);
 
-		if ((head -> cell).x == current_coordinates.x && (head -> cell).y == current_coordinates.y) {
+	maze = create_maze(maze_size);
+	set_maze_layout(maze, 0.6, 5, 1, S, goals);
 
-			//printf("[%d][%d] is part of the Search Frontier.\n", (head -> cell).x, (head -> cell).y);
-			return 1;
+	save_maze(maze, S, goal_cells, 2, "test_maze.bin");
+	loaded = load_maze("test_maze.bin", &loaded_S, &loaded_goal_cells, &loaded_goal_count);
+
+	printf("Maze file round trip: %s\n",
+		(loaded -> size == maze_size && loaded_S.x == S.x && loaded_S.y == S.y && loaded_goal_count == 2
+		&& memcmp(loaded_goal_cells, goal_cells, sizeof(goal_cells)) == 0
+		&& memcmp(loaded -> cells, maze -> cells, (size_t)maze_size * maze -> stride * sizeof(uint64_t)) == 0) ? "ok" : "failed");
+
+	remove("test_maze.bin");
+	free_maze(loaded);
+	free_maze(maze);
+	free(loaded_goal_cells);
+	free_goals(goals);
+}
+
+void test_search_stats() {
+
+	coordinates_t S, G;
+	goals_t *goals = NULL;
+	maze_t *maze = NULL;
+	workspace_t *workspace = NULL;
+	search_result_t result;
+	search_stats_t *stats = &(result.stats);
+	int maze_size = 100;
+
+	S.x = S.y = 0;
+	G.x = G.y = maze_size - 1;
+	goals = new_goals(&G, 1, maze_size);
+
+	maze = create_maze(maze_size);
+	set_maze_layout(maze, 0.7, 8, 1, S, goals);
+
+	workspace = new_workspace(FRONTIER_BINARY_HEAP, maze_size);
+	best_first(workspace, maze, S, goals, 1, &result);
+
+	// Every pop is either stale, an expansion, or the exit.
+	printf("Pops accounted for: %s\n", (stats -> pops == stats -> stale_pops + stats -> closed_count + (result.goal != 0)) ? "yes" : "no");
+	printf("Pushes match expansions: %s\n", (stats -> pushes == result.expansion_count + 1) ? "yes" : "no");
+	print_search_stats(stats);
+
+	free_workspace(workspace);
+	free_maze(maze);
+	free_goals(goals);
+}
+
+void test_hpa(maze_t *maze) {
+
+	/*	HPA* against A* for routes from every 37th free cell to the free cell closest to the opposite corner:
+		both must agree on whether the exit can be reached, and HPA* may never beat the optimal cost.
+	*/
+	coordinates_t start, corner;
+	coordinates_t *path = NULL;
+	goals_t *goals = NULL;
+	hpa_t *hpa = new_hpa(maze, HPA_CLUSTER_SIZE);
+	workspace_t *workspace = new_workspace(FRONTIER_BINARY_HEAP, maze -> size);
+	search_result_t optimal, hierarchical;
+	int maze_size = maze -> size;
+	int query_count = 0, mismatches = 0, extra_cost = 0, optimal_cost = 0;
+
+	corner.x = maze_size - 1;
+	for (corner.y = maze_size - 1; corner.y > 0 && maze_cell(maze, corner.x, corner.y) == 0; corner.y--);
+	goals = new_goals(&corner, 1, maze_size);
+
+	for (start.x = 0; start.x < maze_size; start.x++) {
+		for (start.y = 0; start.y < maze_size; start.y++) {
+
+			if ((start.x * maze_size + start.y) % 37 != 0 || maze_cell(maze, start.x, start.y) == 0) {
+
+				continue;
+			}
+
+			best_first(workspace, maze, start, goals, 1, &optimal);
+			path = hpa_search(hpa, start, goals, &hierarchical);
+			free(path);
+
+			query_count++;
+			if (optimal.goal != hierarchical.goal || hierarchical.path_cost < optimal.path_cost) {
+
+				mismatches++;
+			}
+			else if (optimal.goal != 0) {
+
+				extra_cost += hierarchical.path_cost - optimal.path_cost;
+				optimal_cost += optimal.path_cost;
+			}
 		}
+	}
+
+	printf("HPA* queries: %d, mismatches: %d, extra cost over A*: %.2f%%\n", query_count, mismatches, (optimal_cost > 0) ? 100.0 * extra_cost / optimal_cost : 0);
+
+	free_workspace(workspace);
+	free_goals(goals);
+	free_hpa(hpa);
+}
+
+void test_components(maze_t *maze) {
+
+	/*	can_reach() against A* from every 13th cell to the opposite corner, the labels must never
+		turn down a route A* finds, nor let through a query A* can't answer.
+	*/
+	coordinates_t start, corner;
+	goals_t *goals = NULL;
+	workspace_t *workspace = new_workspace(FRONTIER_BINARY_HEAP, maze -> size);
+	search_result_t result;
+	uint32_t *labels = NULL;
+	int maze_size = maze -> size;
+	int query_count = 0, mismatches = 0;
+
+	corner.x = maze_size - 1;
+	corner.y = maze_size - 1;
+	goals = new_goals(&corner, 1, maze_size);
+
+	label_components(maze);
+	labels = maze -> component;
+	maze -> component = NULL;		// Plain searches, to compare with.
+
+	for (start.x = 0; start.x < maze_size; start.x++) {
+		for (start.y = 0; start.y < maze_size; start.y++) {
+
+			if ((start.x * maze_size + start.y) % 13 != 0 || maze_cell(maze, start.x, start.y) == 0) {
+
+				continue;
+			}
+
+			best_first(workspace, maze, start, goals, 1, &result);
+
+			maze -> component = labels;
+			if ((result.goal != 0) != can_reach(maze, start, goals)) {
+
+				mismatches++;
+			}
+			maze -> component = NULL;
 
-		head = head -> next;
+			query_count++;
+		}
 	}
 
-	return 0;
+	maze -> component = labels;
+	printf("Components: %u, queries: %d, mismatches: %d\n", maze -> component_count, query_count, mismatches);
+
+	free_workspace(workspace);
+	free_goals(goals);
 }
 
-int is_goal(coordinates_t current_node, coordinates_t G1, coordinates_t G2) {
+goals_t *new_test_queries(maze_t *maze, int every, coordinates_t exits[2], coordinates_t **starts, int *start_count) {
 
-	if (current_node.x == G1.x && current_node.y == G1.y) {
+	/*	The queries most search tests run: from the free cells whose raster index is a multiple of 'every'
+		to two exits on the bottom row, its last cell and its middle one, written to 'exits'. The goals point into
+		'exits', so it has to outlive them. The caller frees the goals and '*starts'.
+	*/
+	coordinates_t start;
+	int maze_size = maze -> size;
 
-		return 1;
+	*starts = (coordinates_t *)malloc(((size_t)maze_size * maze_size / every + 1) * sizeof(coordinates_t));
+	if (*starts == NULL) {
+
+		printf("Trouble allocating memory for test queries.\n");
+		exit(1);
 	}
-	else if (current_node.x == G2.x && current_node.y == G2.y) {
 
-		return 2;
+	*start_count = 0;
+	for (start.x = 0; start.x < maze_size; start.x++) {
+		for (start.y = 0; start.y < maze_size; start.y++) {
+
+			if (((size_t)start.x * maze_size + start.y) % every == 0 && maze_cell(maze, start.x, start.y)) {
+
+				(*starts)[(*start_count)++] = start;
+			}
+		}
 	}
 
-	return 0;
+	exits[0].x = maze_size - 1;
+	exits[0].y = maze_size - 1;
+	exits[1].x = maze_size - 1;
+	exits[1].y = maze_size / 2;
+
+	return new_goals(exits, 2, maze_size);
 }
 
-int is_visited(coordinates_t current_node, coordinates_t *visited, int visited_count) {
+int route_is_valid(maze_t *maze, coordinates_t *path, int path_cost, coordinates_t S, goals_t *goals) {	// Starts at S, ends on an exit, moves between neighbouring open cells.
 
-	int i;
+	int step;
+
+	if (path[0].x != S.x || path[0].y != S.y || !is_goal(path[path_cost], goals)) {
 
-	for (i = 0; i < visited_count; i++) {
+		return 0;
+	}
 
-		if (current_node.x == (visited[i]).x && current_node.y == (visited[i]).y) {
+	for (step = 1; step <= path_cost; step++) {
 
-			return 1;
+		if (!in_maze(path[step], maze -> size) || !maze_cell(maze, path[step].x, path[step].y)
+			|| abs(path[step].x - path[step - 1].x) > 1 || abs(path[step].y - path[step - 1].y) > 1) {
+
+			return 0;
 		}
 	}
 
-	return 0;
+	return 1;
 }
 
-void push_visited(coordinates_t current_node, coordinates_t **visited, int *visited_count) {
+void test_dstar(maze_t *maze, coordinates_t S, goals_t *goals) {
 
-	(*visited)[(*visited_count)] = current_node;
-	(*visited_count)++;
-}
+	/*	Toggles 200 cells near the middle of the maze one at a time, replanning after each with D* Lite and
+		with a fresh A*. Costs must match and every D* Lite route must be walkable. Changes the maze.
+	*/
+	dstar_t *dstar = new_dstar(maze, S, goals);
+	workspace_t *workspace = new_workspace(FRONTIER_BINARY_HEAP, maze -> size);
+	search_result_t result;
+	coordinates_t *path = NULL;
+	coordinates_t cell;
+	int maze_size = maze -> size;
+	int i, x, y, path_cost, mismatches = 0, bad_routes = 0;
+	long repair_expansions = 0, search_expansions = 0;
 
-void print_path(coordinates_t *path, int path_count) {
+	dstar_plan(dstar);
 
-	int i;
+	for (i = 0; i < 200; i++) {
 
-	printf("Path:\n");
+		x = maze_size / 4 + (int)(cell_random(i, 1, 2) % (maze_size / 2));
+		y = maze_size / 4 + (int)(cell_random(i, 3, 4) % (maze_size / 2));
+
+		cell.x = x;
+		cell.y = y;
+		if ((x == S.x && y == S.y) || is_goal(cell, goals)) {
+
+			continue;
+		}
 
-	for (i = 0; i < path_count; i++) {
+		dstar_set_cell(dstar, x, y, !maze_cell(maze, x, y));
 
-		if (i > 0 && i % 5 == 0) {
+		path_cost = dstar_plan(dstar);
+		repair_expansions += dstar -> expansion_count;
 
-			printf("\n");
-		}
+		best_first(workspace, maze, S, goals, 1, &result);
+		search_expansions += result.stats.closed_count;
 
-		if (i == path_count - 1) {
+		if (path_cost != result.path_cost) {
 
-			printf("[%d][%d]\n", (path[i]).x, (path[i]).y);
-			break;
+			mismatches++;
+			continue;
 		}
 
-		printf("[%d][%d] -> ", (path[i]).x, (path[i]).y);
-	}
+		if (path_cost < 0) {
 
-	printf("Path cost: %d.\n", path_count - 1);
-}
+			continue;
+		}
 
-int heuristic(coordinates_t current_coordinates, coordinates_t goal_coordinates) {
+		path = dstar_path(dstar, path_cost);
+		if (!route_is_valid(maze, path, path_cost, S, goals)) {
 
-	int dx, dy;
-	int D = 1;		// Minimum cost for moving from one node to an adjacent node (moving in 4 directions, not counting diagonal movement).
-	int D2 = 1;		// Minimum cost for moving from one node to an adjacent node diagonally.
-	int min;
+			bad_routes++;
+		}
 
-	dx = abs(current_coordinates.x - goal_coordinates.x);
-	dy = abs(current_coordinates.y - goal_coordinates.y);
+		free(path);
+	}
 
-	if (dx < dy) { min = dx; }
-	else { min = dy; }
+	printf("D* Lite cost mismatches: %d, bad routes: %d, expansions repairing: %ld, searching again: %ld\n", mismatches, bad_routes, repair_expansions, search_expansions);
 
-	return D * (dx + dy) + (D2 - (2 * D)) * min;
+	free_workspace(workspace);
+	free_dstar(dstar);
 }
 
-int min_heuristic(int h1, int h2) {
+void test_wavefront(maze_t *maze) {
 
-	if (h1 < h2) { return h1; }
+	/*	Wavefront BFS against UCS from every 97th free cell to two exits on the bottom row: costs must match
+		and every route must start at S, end on an exit and move between neighbouring open cells.
+		The same flood on 4 threads must give exactly the same route.
+	*/
+	coordinates_t start;
+	coordinates_t exits[2];
+	coordinates_t *starts = NULL;
+	coordinates_t *path = NULL, *parallel_path = NULL;
+	goals_t *goals = NULL;
+	workspace_t *workspace = new_workspace(FRONTIER_BUCKET_QUEUE, maze -> size);
+	search_result_t optimal, flood, parallel_flood;
+	int i, start_count, query_count = 0, mismatches = 0, bad_routes = 0, different_routes = 0;
 
-	return h2;
-}
+	goals = new_test_queries(maze, 97, exits, &starts, &start_count);
 
-// -----------------------------------
-// 		  Uniform Cost Search
-// -----------------------------------
+	for (i = 0; i < start_count; i++) {
 
-void ucs(int **maze, int maze_size, coordinates_t S, coordinates_t G1, coordinates_t G2) {
+		start = starts[i];
 
-	node_t *search_frontier = NULL;
-	coordinates_t *visited = NULL;						// List of already expanded nodes, in other words, "closed set".
-	coordinates_t *path = NULL, *new_path = NULL;
-	coordinates_t current_coordinates, new_coordinates;
-	int **priority = NULL;		// The g(n) value of each node.
-	int visited_count = 0;
-	int expansion_count = 0, path_count = 0;
+		best_first(workspace, maze, start, goals, 0, &optimal);
+		path = wavefront_search(maze, start, goals, 1, &flood);
+		parallel_path = wavefront_search(maze, start, goals, 4, &parallel_flood);
 
-	search_frontier = new_node(S, 0);
+		query_count++;
+		if (parallel_flood.path_cost != flood.path_cost || (path != NULL && memcmp(path, parallel_path, (flood.path_cost + 1) * sizeof(coordinates_t)) != 0)) {
 
-	priority = assign_cost(maze, maze_size, S);
+			different_routes++;
+		}
 
-	visited = (coordinates_t *)malloc((maze_size * maze_size) * sizeof(coordinates_t));
-	if (visited == NULL) {
+		if (optimal.path_cost != flood.path_cost) {
 
-		printf("[UCS] Trouble allocating memory for 'visited' list.\n");
-		exit(1);
-	}
+			mismatches++;
+		}
+		else if (path != NULL && !route_is_valid(maze, path, flood.path_cost, start, goals)) {
 
-	path = (coordinates_t *)malloc(sizeof(coordinates_t));
-	if (path == NULL) {
+			bad_routes++;
+		}
 
-		printf("[UCS] Trouble allocating memory for 'path' array.\n");
-		exit(1);
+		free(path);
+		free(parallel_path);
 	}
 
-	while (!is_empty(&search_frontier)) {
+	printf("Wavefront queries: %d, cost mismatches: %d, bad routes: %d, routes differing on 4 threads: %d\n", query_count, mismatches, bad_routes, different_routes);
 
-		current_coordinates = peek(&search_frontier);
-
-		if (is_visited(current_coordinates, visited, visited_count)) {
+	free_workspace(workspace);
+	free_goals(goals);
+	free(starts);
+}
 
-			pop(&search_frontier);
-			continue;
-		}
+void test_jps(maze_t *maze, int frontier_type) {
 
-		path[path_count] = current_coordinates;
-		path_count++;
-		new_path = (coordinates_t *)realloc(path, (path_count + 1) * sizeof(coordinates_t));
-		if (new_path == NULL) {
+	/*	Jump Point Search against UCS from every 31st free cell to two exits on the bottom row: costs must match
+		and every route must start at S, end on an exit and move between neighbouring open cells.
+	*/
+	coordinates_t start;
+	coordinates_t exits[2];
+	coordinates_t *starts = NULL;
+	coordinates_t *path = NULL;
+	goals_t *goals = NULL;
+	workspace_t *workspace = new_workspace(FRONTIER_BUCKET_QUEUE, maze -> size);
+	search_result_t optimal, answer;
+	int i, start_count, query_count = 0, mismatches = 0, bad_routes = 0;
 
-			printf("[UCS] Trouble reallocating memory for path.\n");
-			exit(1);
-		}
-		path = new_path;
+	goals = new_test_queries(maze, 31, exits, &starts, &start_count);
 
-		if (is_goal(current_coordinates, G1, G2) == 1) {
+	for (i = 0; i < start_count; i++) {
 
-			printf("Reached G1[%d][%d]\n", G1.x, G1.y);
+		start = starts[i];
 
-			print_path(path, path_count);
-			printf("Number of expansions: %d.\n", expansion_count);
-			return;
-		}
-		else if (is_goal(current_coordinates, G1, G2) == 2) {
+		best_first(workspace, maze, start, goals, 0, &optimal);
+		path = jps_search(maze, start, goals, frontier_type, &answer);
 
-			printf("Reached G2[%d][%d]\n", G2.x, G2.y);
+		query_count++;
+		if (optimal.path_cost != answer.path_cost) {
 
-			print_path(path, path_count);
-			printf("Number of expansions: %d.\n", expansion_count);
-			return;
+			mismatches++;
 		}
+		else if (path != NULL && !route_is_valid(maze, path, answer.path_cost, start, goals)) {
 
-		// Apply Transition Operators for each node of the Search Frontier (clockwise).
+			bad_routes++;
+		}
 
-		// Move upwards.
-		if (current_coordinates.x > 0) {
+		free(path);
+	}
 
-			if (maze[current_coordinates.x - 1][current_coordinates.y] == 1) {
+	printf("JPS queries: %d, cost mismatches: %d, bad routes: %d\n", query_count, mismatches, bad_routes);
 
-				new_coordinates.x = current_coordinates.x - 1;
-				new_coordinates.y = current_coordinates.y;
-				if (!check_frontier(&search_frontier, new_coordinates) && !is_visited(new_coordinates, visited, visited_count)) {
-					
-					push(&search_frontier, new_coordinates, priority[new_coordinates.x][new_coordinates.y]);
-					expansion_count++;
-				}
-			}
-		}
+	free_workspace(workspace);
+	free_goals(goals);
+	free(starts);
+}
 
-		// Upper right diagonal.
-		if (current_coordinates.x > 0 && current_coordinates.y < maze_size - 1) {
+void test_oracle(maze_t *maze) {
 
-			if (maze[current_coordinates.x - 1][current_coordinates.y + 1] == 1) {
+	/*	Goal oracle against UCS from every 31st free cell to two exits on the bottom row: costs must match
+		and every route must start at S, end on an exit and move between neighbouring open cells.
+	*/
+	coordinates_t start;
+	coordinates_t exits[2];
+	coordinates_t *starts = NULL;
+	coordinates_t *path = NULL;
+	goals_t *goals = NULL;
+	oracle_t *oracle = NULL;
+	workspace_t *workspace = new_workspace(FRONTIER_BUCKET_QUEUE, maze -> size);
+	search_result_t optimal, answer;
+	int i, start_count, query_count = 0, mismatches = 0, bad_routes = 0;
 
-				new_coordinates.x = current_coordinates.x - 1;
-				new_coordinates.y = current_coordinates.y + 1;
-				if (!check_frontier(&search_frontier, new_coordinates) && !is_visited(new_coordinates, visited, visited_count)) {
-					
-					push(&search_frontier, new_coordinates, priority[new_coordinates.x][new_coordinates.y]);
-					expansion_count++;
-				}
-			}
-		}
+	goals = new_test_queries(maze, 31, exits, &starts, &start_count);
+	oracle = new_oracle(maze, goals);
 
-		// Move to the right.
-		if (current_coordinates.y < maze_size - 1) {
+	for (i = 0; i < start_count; i++) {
 
-			if (maze[current_coordinates.x][current_coordinates.y + 1] == 1) {
+		start = starts[i];
 
-				new_coordinates.x = current_coordinates.x;
-				new_coordinates.y = current_coordinates.y + 1;
-				if (!check_frontier(&search_frontier, new_coordinates) && !is_visited(new_coordinates, visited, visited_count)) {
-					
-					push(&search_frontier, new_coordinates, priority[new_coordinates.x][new_coordinates.y]);
-					expansion_count++;
-				}
-			}
-		}
+		best_first(workspace, maze, start, goals, 0, &optimal);
+		path = oracle_search(oracle, start, &answer);
 
-		// Down right diagonal.
-		if (current_coordinates.x < maze_size - 1 && current_coordinates.y < maze_size - 1) {
+		query_count++;
+		if (optimal.path_cost != answer.path_cost) {
 
-			if (maze[current_coordinates.x + 1][current_coordinates.y + 1] == 1) {
+			mismatches++;
+		}
+		else if (path != NULL && !route_is_valid(maze, path, answer.path_cost, start, goals)) {
 
-				new_coordinates.x = current_coordinates.x + 1;
-				new_coordinates.y = current_coordinates.y + 1;
-				if (!check_frontier(&search_frontier, new_coordinates) && !is_visited(new_coordinates, visited, visited_count)) {
-					
-					push(&search_frontier, new_coordinates, priority[new_coordinates.x][new_coordinates.y]);
-					expansion_count++;
-				}
-			}
+			bad_routes++;
 		}
 
-		// Move downwards.
-		if (current_coordinates.x < maze_size - 1) {
+		free(path);
+	}
 
-			if (maze[current_coordinates.x + 1][current_coordinates.y] == 1) {
+	printf("Oracle queries: %d, cost mismatches: %d, bad routes: %d\n", query_count, mismatches, bad_routes);
 
-				new_coordinates.x = current_coordinates.x + 1;
-				new_coordinates.y = current_coordinates.y;
-				if (!check_frontier(&search_frontier, new_coordinates) && !is_visited(new_coordinates, visited, visited_count)) {
-					
-					push(&search_frontier, new_coordinates, priority[new_coordinates.x][new_coordinates.y]);
-					expansion_count++;
-				}
-			}
-		}
+	free_oracle(oracle);
+	free_workspace(workspace);
+	free_goals(goals);
+	free(starts);
+}
 
-		// Down left diagonal.
-		if (current_coordinates.x < maze_size - 1 && current_coordinates.y > 0) {
+void test_cpd(maze_t *maze) {
 
-			if (maze[current_coordinates.x + 1][current_coordinates.y - 1] == 1) {
+	/*	Path database against A* for 500 pairs of free cells, before and after a save and load round trip:
+		costs must match, and the loaded database must give the very same routes.
+	*/
+	cpd_t *cpd = new_cpd(maze, 3), *loaded = NULL;
+	workspace_t *workspace = new_workspace(FRONTIER_BINARY_HEAP, maze -> size);
+	search_result_t optimal, answer, loaded_answer;
+	coordinates_t start, target;
+	coordinates_t *path = NULL, *loaded_path = NULL;
+	goals_t *goals = NULL;
+	int maze_size = maze -> size;
+	int i, query_count = 0, mismatches = 0, different_routes = 0;
+
+	save_cpd(cpd, "test_maze.cpd");
+	loaded = load_cpd(maze, "test_maze.cpd");
+
+	for (i = 0; i < 500; i++) {
+
+		start.x = (int)(cell_random(i, 5, 6) % maze_size);
+		start.y = (int)(cell_random(i, 7, 8) % maze_size);
+		target.x = (int)(cell_random(i, 9, 10) % maze_size);
+		target.y = (int)(cell_random(i, 11, 12) % maze_size);
+		if (!maze_cell(maze, start.x, start.y) || !maze_cell(maze, target.x, target.y)) {
 
-				new_coordinates.x = current_coordinates.x + 1;
-				new_coordinates.y = current_coordinates.y - 1;
-				if (!check_frontier(&search_frontier, new_coordinates) && !is_visited(new_coordinates, visited, visited_count)) {
-					
-					push(&search_frontier, new_coordinates, priority[new_coordinates.x][new_coordinates.y]);
-					expansion_count++;
-				}
-			}
+			continue;
 		}
 
-		// Move to the left.
-		if (current_coordinates.y > 0) {
+		goals = new_goals(&target, 1, maze_size);
+		best_first(workspace, maze, start, goals, 1, &optimal);
+		path = cpd_search(cpd, start, goals, &answer);
+		loaded_path = cpd_search(loaded, start, goals, &loaded_answer);
 
-			if (maze[current_coordinates.x][current_coordinates.y - 1] == 1) {
+		query_count++;
+		if (optimal.path_cost != answer.path_cost) {
 
-				new_coordinates.x = current_coordinates.x;
-				new_coordinates.y = current_coordinates.y - 1;
-				if (!check_frontier(&search_frontier, new_coordinates) && !is_visited(new_coordinates, visited, visited_count)) {
-					
-					push(&search_frontier, new_coordinates, priority[new_coordinates.x][new_coordinates.y]);
-					expansion_count++;
-				}
-			}
+			mismatches++;
 		}
-		
-		// Upper left diagonal.
-		if (current_coordinates.x > 0 && current_coordinates.y > 0) {
 
-			if (maze[current_coordinates.x - 1][current_coordinates.y - 1] == 1) {
+		if (loaded_answer.path_cost != answer.path_cost || (path != NULL && memcmp(path, loaded_path, (answer.path_cost + 1) * sizeof(coordinates_t)) != 0)) {
 
-				new_coordinates.x = current_coordinates.x - 1;
-				new_coordinates.y = current_coordinates.y - 1;
-				if (!check_frontier(&search_frontier, new_coordinates) && !is_visited(new_coordinates, visited, visited_count)) {
-					
-					push(&search_frontier, new_coordinates, priority[new_coordinates.x][new_coordinates.y]);
-					expansion_count++;
-				}
-			}
+			different_routes++;
 		}
 
-		push_visited(current_coordinates, &visited, &visited_count);
-
-		pop(&search_frontier);
+		free(path);
+		free(loaded_path);
+		free_goals(goals);
 	}
 
-	printf("Unable to reach G1[%d][%d] nor G2[%d][%d].\n", G1.x, G1.y, G2.x, G2.y);
-
-	free(search_frontier);
-	free(visited);
-	free(path);
-	free(priority);
+	printf("Path database queries: %d, cost mismatches: %d, routes differing after loading: %d, runs: %" PRIu64 "\n", query_count, mismatches, different_routes, cpd -> run_count);
 
-	return;
+	remove("test_maze.cpd");
+	free_workspace(workspace);
+	free_cpd(loaded);
+	free_cpd(cpd);
 }
 
-// -----------------------------------
-// 				  A*
-// -----------------------------------
+void test_landmarks(maze_t *maze) {
 
-void a_star(int **maze, int maze_size, coordinates_t S, coordinates_t G1, coordinates_t G2) {
+	/*	A* with and without landmarks from every 97th free cell to two exits on the bottom row: the ALT bound
+		is admissible and consistent, so costs must match, and it should expand fewer cells.
+	*/
+	coordinates_t start;
+	coordinates_t exits[2];
+	coordinates_t *starts = NULL;
+	goals_t *goals = NULL;
+	landmarks_t *landmarks = new_landmarks(maze, ALT_LANDMARKS);
+	workspace_t *workspace = new_workspace(FRONTIER_BUCKET_QUEUE, maze -> size);
+	search_result_t octile, alt;
+	int i, start_count, query_count = 0, mismatches = 0;
+	long octile_expansions = 0, alt_expansions = 0;
 
-	node_t *search_frontier = NULL;
-	coordinates_t *visited = NULL;
-	coordinates_t *path = NULL, *new_path = NULL;
-	int *score = NULL;		// The result of f(n) = g(n) + h(n). Its index is synchronized with "visited" lists index "visited_count".
-	int **cost = NULL;		// The g(n) value of each node.
-	coordinates_t current_coordinates, new_coordinates;
-	int visited_count = 0, path_count = 0;
-	int current_heuristic = 0, expansion_count = 0;
+	goals = new_test_queries(maze, 97, exits, &starts, &start_count);
 
-	visited = (coordinates_t *)malloc((maze_size * maze_size) * sizeof(coordinates_t));
-	if (visited == NULL) {
+	for (i = 0; i < start_count; i++) {
 
-		printf("[A*] Trouble allocating memory for 'visited' list.\n");
-		exit(1);
-	}
+		start = starts[i];
 
-	score = (int *)malloc((maze_size * maze_size) * sizeof(int));
-	if (score == NULL) {
+		best_first(workspace, maze, start, goals, 1, &octile);
+		use_landmarks(goals, landmarks);
+		best_first(workspace, maze, start, goals, 1, &alt);
+		use_landmarks(goals, NULL);
 
-		printf("[A*] Trouble allocating memory for 'score' list.\n");
-		exit(1);
-	}
+		query_count++;
+		if (octile.path_cost != alt.path_cost) {
 
-	path = (coordinates_t *)malloc(sizeof(coordinates_t));
-	if (path == NULL) {
+			mismatches++;
+		}
 
-		printf("[A*] Trouble allocating memory for 'path' list.\n");
-		exit(1);
+		octile_expansions += octile.stats.closed_count;
+		alt_expansions += alt.stats.closed_count;
 	}
 
-	cost = assign_cost(maze, maze_size, S);
+	printf("ALT queries: %d, cost mismatches: %d, cells expanded with octile distance: %ld, with landmarks: %ld\n", query_count, mismatches, octile_expansions, alt_expansions);
 
-	search_frontier = new_node(S, min_heuristic(heuristic(S, G1), heuristic(S, G2)) + cost[S.x][S.y]);
+	free_workspace(workspace);
+	free_goals(goals);
+	free(starts);
+	free_landmarks(landmarks);
+}
 
-	while (!is_empty(&search_frontier)) {
+void test_landmarks_far() {
 
-		current_coordinates = peek(&search_frontier);
+	/*	A serpentine corridor longer than a 16 bit distance: past the cap the landmark bound must stay consistent,
+		dropping by at most 1 per move, and A* with landmarks must still find the corridor's cost.
+	*/
+	coordinates_t start, exit_cell, current, next;
+	maze_t *maze = create_maze(400);
+	goals_t *goals = NULL;
+	landmarks_t *landmarks = NULL;
+	workspace_t *workspace = new_workspace(FRONTIER_BUCKET_QUEUE, maze -> size);
+	search_result_t octile, alt;
+	int maze_size = maze -> size;
+	int move, inconsistencies = 0;
+	long capped = 0;
+	size_t cell;
+
+	for (current.x = 0; current.x < maze_size; current.x++) {
+		for (current.y = 0; current.y < maze_size; current.y++) {
+
+			// Even rows are open, odd rows only at one end, alternating sides.
+			if (current.x % 2 == 0 || (current.x % 4 == 1 && current.y == maze_size - 1) || (current.x % 4 == 3 && current.y == 0)) {
+
+				set_maze_cell(maze, current.x, current.y, 1);
+			}
+		}
+	}
 
-		current_heuristic = min_heuristic(heuristic(current_coordinates, G1), heuristic(current_coordinates, G2)) + cost[current_coordinates.x][current_coordinates.y];
+	start.x = 0;
+	start.y = 0;
+	exit_cell.x = maze_size - 2;
+	exit_cell.y = 0;
+	goals = new_goals(&exit_cell, 1, maze_size);
+	landmarks = new_landmarks(maze, ALT_LANDMARKS);
+	use_landmarks(goals, landmarks);
 
-		if (is_visited(current_coordinates, visited, visited_count)) {
+	for (current.x = 0; current.x < maze_size; current.x++) {
+		for (current.y = 0; current.y < maze_size; current.y++) {
 
-			if (score[visited_count] < current_heuristic) {		// FIX || Wrong index.
+			if (maze_cell(maze, current.x, current.y) == 0) {
 
-				pop(&search_frontier);
 				continue;
 			}
-			else {
 
-				score[visited_count] = current_heuristic;		// FIX || Wrong index.
-			}											
-		}
+			for (move = 0; move < 8; move++) {
 
-		path[path_count] = current_coordinates;
-		path_count++;
-		new_path = (coordinates_t *)realloc(path, (path_count + 1) * sizeof(coordinates_t));
-		if (new_path == NULL) {
+				next.x = current.x + move_x[move];
+				next.y = current.y + move_y[move];
 
-			printf("[A*] Trouble reallocating memory for 'path' list.\n");
-			exit(1);
+				if (in_maze(next, maze_size) && maze_cell(maze, next.x, next.y) && landmark_heuristic(current, goals) > landmark_heuristic(next, goals) + 1) {
+
+					inconsistencies++;
+				}
+			}
 		}
-		path = new_path;
+	}
 
-		if (is_goal(current_coordinates, G1, G2) == 1) {
+	best_first(workspace, maze, start, goals, 1, &alt);
+	use_landmarks(goals, NULL);
+	best_first(workspace, maze, start, goals, 1, &octile);
 
-			printf("Reached G1[%d][%d].\n", G1.x, G1.y);
+	for (cell = 0; cell < (size_t)maze_size * maze_size * landmarks -> count; cell++) {
 
-			print_path(path, path_count);
-			printf("Number of expansions: %d.\n", expansion_count);
+		capped += (landmarks -> distance[cell] == LANDMARK_UNKNOWN - 1);
+	}
 
-			return;
-		}
-		else if (is_goal(current_coordinates, G1, G2) == 2) {
+	printf("Far ALT corridor cost: %d, with landmarks: %d, capped distances: %ld, inconsistent moves: %d\n", octile.path_cost, alt.path_cost, capped, inconsistencies);
 
-			printf("Reached G2[%d][%d].\n", G2.x, G2.y);
+	free_workspace(workspace);
+	free_goals(goals);
+	free_landmarks(landmarks);
+	free_maze(maze);
+}
 
-			print_path(path, path_count);
-			printf("Number of expansions: %d.\n", expansion_count);
+void test_ara(maze_t *maze) {
 
-			return;
-		}
+	/*	From every 97th free cell to two exits on the bottom row: weighted A* must stay within its weight of A*'s cost,
+		every route ARA* reports must stay within its bound, and with time to spare ARA* must end on an optimal route.
+	*/
+	coordinates_t start;
+	coordinates_t exits[2];
+	coordinates_t *starts = NULL;
+	coordinates_t *path = NULL;
+	goals_t *goals = NULL;
+	workspace_t *workspace = new_workspace(FRONTIER_BINARY_HEAP, maze -> size);
+	search_result_t optimal, weighted;
+	ara_t *ara = NULL;
+	int i, start_count, path_cost, query_count = 0, weighted_violations = 0, bound_violations = 0, not_optimal = 0;
 
-		// Apply Transition Operators for each node of the Search Frontier (clockwise).
+	goals = new_test_queries(maze, 97, exits, &starts, &start_count);
 
-		// Move upwards.
-		if (current_coordinates.x > 0) {
+	for (i = 0; i < start_count; i++) {
 
-			if (maze[current_coordinates.x - 1][current_coordinates.y] == 1) {
+		start = starts[i];
 
-				new_coordinates.x = current_coordinates.x - 1;
-				new_coordinates.y = current_coordinates.y;
-				if (!check_frontier(&search_frontier, new_coordinates) && !is_visited(new_coordinates, visited, visited_count)) {
+		best_first(workspace, maze, start, goals, 1, &optimal);
+		weighted_best_first(workspace, maze, start, goals, ARA_INITIAL_WEIGHT, &weighted);
+		if ((weighted.goal == 0) != (optimal.goal == 0) || (optimal.goal != 0 && weighted.path_cost > ARA_INITIAL_WEIGHT * optimal.path_cost)) {
 
-					push(&search_frontier, new_coordinates, min_heuristic(heuristic(new_coordinates, G1), heuristic(new_coordinates, G2)) + cost[new_coordinates.x][new_coordinates.y]);
-					expansion_count++;
-					//printf("Pushing new node with coordinates[%d][%d] of priority %d.\n", new_coordinates.x, new_coordinates.y, priority[new_coordinates.x][new_coordinates.y]);
-				}
-			}
+			weighted_violations++;
 		}
 
-		// Upper right diagonal.
-		if (current_coordinates.x > 0 && current_coordinates.y < maze_size - 1) {
+		ara = new_ara(maze, start, goals, ARA_INITIAL_WEIGHT, ARA_WEIGHT_STEP);
+		while (ara_search(ara, now_ns() + 60000000000L)) {
 
-			if (maze[current_coordinates.x - 1][current_coordinates.y + 1] == 1) {
+			if (ara -> goal != 0 && ara -> goal_cost > ara -> bound * optimal.path_cost + 1e-9) {
 
-				new_coordinates.x = current_coordinates.x - 1;
-				new_coordinates.y = current_coordinates.y + 1;
-				if (!check_frontier(&search_frontier, new_coordinates) && !is_visited(new_coordinates, visited, visited_count)) {
-					
-					if (!check_frontier(&search_frontier, new_coordinates) && !is_visited(new_coordinates, visited, visited_count)) {
-
-						push(&search_frontier, new_coordinates, min_heuristic(heuristic(new_coordinates, G1), heuristic(new_coordinates, G2)) + cost[new_coordinates.x][new_coordinates.y]);
-						expansion_count++;
-						//printf("Pushing new node with coordinates[%d][%d] of priority %d.\n", new_coordinates.x, new_coordinates.y, priority[new_coordinates.x][new_coordinates.y]);
-					}
-				}
+				bound_violations++;
 			}
 		}
 
-		// Move to the right.
-		if (current_coordinates.y < maze_size - 1) {
+		path = ara_path(ara, &path_cost);
+		query_count++;
+		if (path_cost != optimal.path_cost || (path != NULL && ara -> bound != 1)) {
+
+			not_optimal++;
+		}
 
-			if (maze[current_coordinates.x][current_coordinates.y + 1] == 1) {
+		free(path);
+		free_ara(ara);
+	}
 
-				new_coordinates.x = current_coordinates.x;
-				new_coordinates.y = current_coordinates.y + 1;
-				if (!check_frontier(&search_frontier, new_coordinates) && !is_visited(new_coordinates, visited, visited_count)) {
-					
-					if (!check_frontier(&search_frontier, new_coordinates) && !is_visited(new_coordinates, visited, visited_count)) {
+	printf("ARA* queries: %d, weighted A* over its bound: %d, ARA* over its bound: %d, final route not optimal: %d\n", query_count, weighted_violations, bound_violations, not_optimal);
 
-						push(&search_frontier, new_coordinates, min_heuristic(heuristic(new_coordinates, G1), heuristic(new_coordinates, G2)) + cost[new_coordinates.x][new_coordinates.y]);
-						expansion_count++;
-						//printf("Pushing new node with coordinates[%d][%d] of priority %d.\n", new_coordinates.x, new_coordinates.y, priority[new_coordinates.x][new_coordinates.y]);
-					}
-				}
-			}
-		}
+	free_workspace(workspace);
+	free_goals(goals);
+	free(starts);
+}
 
-		// Down right diagonal.
-		if (current_coordinates.x < maze_size - 1 && current_coordinates.y < maze_size - 1) {
+void test_search_step(maze_t *maze, int frontier_type) {
 
-			if (maze[current_coordinates.x + 1][current_coordinates.y + 1] == 1) {
+	/*	From every 97th free cell to two exits on the bottom row, searches run one cell at a time and 37 cells at a time
+		must end exactly like the ones run in one call, and interleaving the queries must not change their answers.
+	*/
+	coordinates_t start;
+	coordinates_t exits[2];
+	coordinates_t *starts = NULL;
+	goals_t *goals = NULL;
+	workspace_t *workspace = new_workspace(frontier_type, maze -> size);
+	search_result_t whole;
+	search_result_t *stepped = NULL;
+	search_t search;
+	query_t *queries = NULL, *interleaved = NULL;
+	int i, start_count, slice, steps, query_count = 0, mismatches = 0, interleave_mismatches = 0;
+
+	goals = new_test_queries(maze, 97, exits, &starts, &start_count);
+
+	queries = (query_t *)malloc((start_count + 1) * sizeof(query_t));
+	interleaved = (query_t *)malloc((start_count + 1) * sizeof(query_t));
+	if (queries == NULL || interleaved == NULL) {
+
+		printf("Trouble allocating memory for queries.\n");
+		exit(1);
+	}
 
-				new_coordinates.x = current_coordinates.x + 1;
-				new_coordinates.y = current_coordinates.y + 1;
-				if (!check_frontier(&search_frontier, new_coordinates) && !is_visited(new_coordinates, visited, visited_count)) {
-					
-					if (!check_frontier(&search_frontier, new_coordinates) && !is_visited(new_coordinates, visited, visited_count)) {
+	for (i = 0; i < start_count; i++) {
 
-						push(&search_frontier, new_coordinates, min_heuristic(heuristic(new_coordinates, G1), heuristic(new_coordinates, G2)) + cost[new_coordinates.x][new_coordinates.y]);
-						expansion_count++;
-						//printf("Pushing new node with coordinates[%d][%d] of priority %d.\n", new_coordinates.x, new_coordinates.y, priority[new_coordinates.x][new_coordinates.y]);
-					}
-				}
-			}
-		}
+		start = starts[i];
 
-		// Move downwards.
-		if (current_coordinates.x < maze_size - 1) {
+		best_first(workspace, maze, start, goals, 1, &whole);
 
-			if (maze[current_coordinates.x + 1][current_coordinates.y] == 1) {
+		for (slice = 1; slice <= 37; slice += 36) {
 
-				new_coordinates.x = current_coordinates.x + 1;
-				new_coordinates.y = current_coordinates.y;
-				if (!check_frontier(&search_frontier, new_coordinates) && !is_visited(new_coordinates, visited, visited_count)) {
-					
-					if (!check_frontier(&search_frontier, new_coordinates) && !is_visited(new_coordinates, visited, visited_count)) {
+			search_begin(&search, workspace, maze, start, goals, 1.0);
+			for (steps = 1; !search_step(&search, slice); steps++);
 
-						push(&search_frontier, new_coordinates, min_heuristic(heuristic(new_coordinates, G1), heuristic(new_coordinates, G2)) + cost[new_coordinates.x][new_coordinates.y]);
-						expansion_count++;
-						//printf("Pushing new node with coordinates[%d][%d] of priority %d.\n", new_coordinates.x, new_coordinates.y, priority[new_coordinates.x][new_coordinates.y]);
-					}
-				}
+			stepped = search_result(&search);
+			if (stepped -> goal != whole.goal || stepped -> path_cost != whole.path_cost || stepped -> stats.closed_count != whole.stats.closed_count || (steps - 1) * (long)slice > whole.stats.closed_count) {
+
+				mismatches++;
 			}
 		}
 
-		// Down left diagonal.
-		if (current_coordinates.x < maze_size - 1 && current_coordinates.y > 0) {
+		queries[query_count].S = start;
+		queries[query_count].goals = goals;
+		query_count++;
+	}
 
-			if (maze[current_coordinates.x + 1][current_coordinates.y - 1] == 1) {
+	memcpy(interleaved, queries, query_count * sizeof(query_t));
 
-				new_coordinates.x = current_coordinates.x + 1;
-				new_coordinates.y = current_coordinates.y - 1;
-				if (!check_frontier(&search_frontier, new_coordinates) && !is_visited(new_coordinates, visited, visited_count)) {
-					
-					if (!check_frontier(&search_frontier, new_coordinates) && !is_visited(new_coordinates, visited, visited_count)) {
+	solve_batch(maze, queries, query_count, 1, 1, frontier_type);
+	solve_interleaved(maze, interleaved, query_count, 3, 50, 1, frontier_type);
 
-						push(&search_frontier, new_coordinates, min_heuristic(heuristic(new_coordinates, G1), heuristic(new_coordinates, G2)) + cost[new_coordinates.x][new_coordinates.y]);
-						expansion_count++;
-						//printf("Pushing new node with coordinates[%d][%d] of priority %d.\n", new_coordinates.x, new_coordinates.y, priority[new_coordinates.x][new_coordinates.y]);
-					}
-				}
-			}
+	for (i = 0; i < query_count; i++) {
+
+		if (queries[i].result.goal != interleaved[i].result.goal || queries[i].result.path_cost != interleaved[i].result.path_cost) {
+
+			interleave_mismatches++;
 		}
+	}
 
-		// Move to the left.
-		if (current_coordinates.y > 0) {
+	printf("Stepped queries: %d, mismatches with whole searches: %d, with interleaved searches: %d\n", query_count, mismatches, interleave_mismatches);
 
-			if (maze[current_coordinates.x][current_coordinates.y - 1] == 1) {
+	free(queries);
+	free(interleaved);
+	free_workspace(workspace);
+	free_goals(goals);
+	free(starts);
+}
 
-				new_coordinates.x = current_coordinates.x;
-				new_coordinates.y = current_coordinates.y - 1;
-				if (!check_frontier(&search_frontier, new_coordinates) && !is_visited(new_coordinates, visited, visited_count)) {
-					
-					if (!check_frontier(&search_frontier, new_coordinates) && !is_visited(new_coordinates, visited, visited_count)) {
+void test_heuristic() {
 
-						push(&search_frontier, new_coordinates, min_heuristic(heuristic(new_coordinates, G1), heuristic(new_coordinates, G2)) + cost[new_coordinates.x][new_coordinates.y]);
-						expansion_count++;
-						//printf("Pushing new node with coordinates[%d][%d] of priority %d.\n", new_coordinates.x, new_coordinates.y, priority[new_coordinates.x][new_coordinates.y]);
-					}
-				}
-			}
-		}
-		
-		// Upper left diagonal.
-		if (current_coordinates.x > 0 && current_coordinates.y > 0) {
+	coordinates_t current_coordinates, goal_coordinates;
 
-			if (maze[current_coordinates.x - 1][current_coordinates.y - 1] == 1) {
+	current_coordinates.x = 1;
+	current_coordinates.y = 3;
 
-				new_coordinates.x = current_coordinates.x - 1;
-				new_coordinates.y = current_coordinates.y - 1;
-				if (!check_frontier(&search_frontier, new_coordinates) && !is_visited(new_coordinates, visited, visited_count)) {
-					
-					if (!check_frontier(&search_frontier, new_coordinates) && !is_visited(new_coordinates, visited, visited_count)) {
+	goal_coordinates.x = 4;
+	goal_coordinates.y = 4;
 
-						push(&search_frontier, new_coordinates, min_heuristic(heuristic(new_coordinates, G1), heuristic(new_coordinates, G2)) + cost[new_coordinates.x][new_coordinates.y]);
-						expansion_count++;
-						//printf("Pushing new node with coordinates[%d][%d] of priority %d.\n", new_coordinates.x, new_coordinates.y, priority[new_coordinates.x][new_coordinates.y]);
-					}
-				}
-			}
-		}
+	printf("Heuristic of [%d][%d] with goal node [%d][%d]: %d\n", current_coordinates.x, current_coordinates.y, goal_coordinates.x, goal_coordinates.y, heuristic(current_coordinates, goal_coordinates));
+}
 
-		push_visited(current_coordinates, &visited, &visited_count);
-		score[visited_count] = current_heuristic;
+void run_tests() {
 
-		pop(&search_frontier);
+	/*	Every test above, on one small generated maze: ./maze --test, or make test, which fails if any of them
+		counts a mismatch, a bad route or a broken bound. make sanitize runs them under ASan and UBSan, make tsan under ThreadSanitizer.
+	*/
+	coordinates_t S;
+	coordinates_t exits[1];
+	goals_t *goals = NULL;
+	maze_t *maze = NULL;
+	int maze_size = 100, frontier_type;
+
+	S.x = 0;
+	S.y = 0;
+	exits[0].x = maze_size - 1;
+	exits[0].y = maze_size - 1;
+	goals = new_goals(exits, 1, maze_size);
+	maze = create_maze(maze_size);
+	set_maze_layout(maze, 0.7, 3, 1, S, goals);
+
+	test_visited();
+	test_push_visited();
+	test_queue(S);
+	test_bucket_queue(S);
+	test_check_frontier(S);
+	test_assign_cost(maze, S);
+	test_heuristic();
+	test_nearest_goal_field();
+	test_maze_layout_reproducible();
+	test_maze_file();
+	test_search_stats();
+
+	for (frontier_type = FRONTIER_BINARY_HEAP; frontier_type <= FRONTIER_BUCKET_QUEUE; frontier_type++) {
+
+		test_solve_batch(maze, frontier_type);
+		test_jps(maze, frontier_type);
+		test_search_step(maze, frontier_type);
 	}
 
-	printf("Unable to reach G1[%d][%d] nor G2[%d][%d].\n", G1.x, G1.y, G2.x, G2.y);
-
-	free(search_frontier);
-	free(visited);
-	free(path);
-	free(score);
-	free(cost);
+	test_hpa(maze);
+	test_components(maze);
+	test_wavefront(maze);
+	test_oracle(maze);
+	test_cpd(maze);
+	test_landmarks(maze);
+	test_landmarks_far();
+	test_ara(maze);
+	test_dstar(maze, S, goals);		// Last, it changes the maze.
+
+	free_goals(goals);
+	free_maze(maze);
 }
 
 // -----------------------------------
-// 				Tests
+// 				Main
 // -----------------------------------
 
-void test_visited() {
+#ifndef MAZE_NO_MAIN	// bench.c includes this file and brings its own main().
 
-	coordinates_t *visited = NULL;
-	coordinates_t current_coordinates;
+int main(int argc, char *argv[]) {
+
+	maze_t *new_maze = NULL;
+	int maze_size, frontier_type;
+	double p;			// Probability of a cell being free. 0 <= p <= 1.
+	uint64_t seed;		// Same seed and p, same maze.
+	coordinates_t S;	// Coordinates of starting cell.
+	coordinates_t *goal_cells = NULL;	// Coordinates of final (exit) cells G1, G2, ...
+	goals_t *goals = NULL;
+	int goal_count;
+	hpa_t *hpa = NULL;	// Abstract graph of the maze, built once and reusable by any number of queries.
+	dstar_t *dstar = NULL;
+	landmarks_t *landmarks = NULL;
+	oracle_t *oracle = NULL;
+	cpd_t *cpd = NULL;	// Path database, only with --cpd FILE: it takes time in the square of the cell count to build.
+	coordinates_t *path = NULL;
+	int path_cost;
+	char *load_file = NULL, *save_file = NULL;	// --load FILE skips the maze prompts, --save FILE keeps the maze for later runs.
+	char *cpd_file = NULL;	// --cpd FILE loads the maze's path database, or builds it and saves it there.
+	int components = 0;		// --components labels the maze's components, so searches from a walled off start are turned down at once.
 	int i;
 
-	visited = (coordinates_t *)malloc(5 * sizeof(coordinates_t));
-	if (visited == NULL) {
+	for (i = 1; i < argc; i++) {
 
-		printf("Trouble allocating memory for 'visited' list.\n");
-		exit(1);
-	}
+		if (strcmp(argv[i], "--load") == 0 && i + 1 < argc) {
 
-	for (i = 1; i < 5; i++) {
+			load_file = argv[++i];
+		}
+		else if (strcmp(argv[i], "--save") == 0 && i + 1 < argc) {
 
-		(visited[i]).x = i;
-		(visited[i]).y = i;
-	}
+			save_file = argv[++i];
+		}
+		else if (strcmp(argv[i], "--cpd") == 0 && i + 1 < argc) {
 
-	for (i = 0; i < 5; i++) {
+			cpd_file = argv[++i];
+		}
+		else if (strcmp(argv[i], "--stats") == 0) {
+
+			show_stats = 1;
+		}
+		else if (strcmp(argv[i], "--components") == 0) {
+
+			components = 1;
+		}
+		else if (strcmp(argv[i], "--test") == 0) {
+
+			run_tests();
+			return 0;
+		}
+		else {
 
-		printf("visited[%d] = [%d][%d]\n", i, (visited[i]).x, (visited[i]).y);
+			printf("Usage: %s [--load FILE] [--save FILE] [--cpd FILE] [--stats] [--components] [--test]\n", argv[0]);
+			exit(1);
+		}
 	}
 
-	current_coordinates.x = 3;
-	current_coordinates.y = 3;
+	if (load_file != NULL) {
 
-	if (is_visited(current_coordinates, visited, 5)) {
+		new_maze = load_maze(load_file, &S, &goal_cells, &goal_count);
+		maze_size = new_maze -> size;
 
-		printf("[%d][%d] is visited.\n", current_coordinates.x, current_coordinates.y);
+		frontier_type = get_frontier_type();
+
+		goals = new_goals(goal_cells, goal_count, maze_size);
 	}
 	else {
 
-		printf("[%d][%d] is not visited.\n", current_coordinates.x, current_coordinates.y);
-	}
-}
+		get_maze_specs(&maze_size, &p, &seed);
 
-void test_push_visited() {
+		frontier_type = get_frontier_type();
 
-	coordinates_t *visited = NULL;
-	coordinates_t current_coordinates, new_coordinates;
-	int i, visited_count = 0;
+		new_maze = create_maze(maze_size);
 
-	visited = (coordinates_t *)malloc(sizeof(coordinates_t));
-	if (visited == NULL) {
+		goal_cells = get_coordinates(&S, &goal_count, maze_size);
 
-		printf("Trouble allocating memory for 'visited' list.\n");
-		exit(1);
-	}
+		goals = new_goals(goal_cells, goal_count, maze_size);
 
-	new_coordinates.x = 5;
-	new_coordinates.y = 5;
+		set_maze_layout(new_maze, p, seed, (int)sysconf(_SC_NPROCESSORS_ONLN), S, goals);
+	}
 
-	push_visited(new_coordinates, &visited, &visited_count);
+	// Once per maze, so a walled off start is turned down before any search starts.
+	if (components) {
 
-	printf("Number of visited nodes: %d\n", visited_count);
+		label_components(new_maze);
+	}
 
-	for (i = 0; i < visited_count; i++) {
+	if (save_file != NULL) {
 
-		printf("Visited[%d] = [%d][%d]\n", i, (visited[i]).x, (visited[i]).y);
+		save_maze(new_maze, S, goal_cells, goal_count, save_file);
 	}
-}
 
-void test_queue(coordinates_t S) {
+	printf("\nUniform Cost Search\n");
 
-	node_t *search_frontier = NULL;
-	int i, priority = 1;
+	ucs(new_maze, S, goals, frontier_type);
 
-	search_frontier = new_node(S, priority);
+	print_maze(new_maze);
 
-	for (i = 0; i < 5; i++) {
+	printf("\nA*\n");
 
-		S.x++;
-		S.y++;
-		priority++;
+	a_star(new_maze, S, goals, frontier_type, NULL, 1.0, 0);
 
-		push(&search_frontier, S, priority);
-	}
+	print_maze(new_maze);
 
-	print_frontier(&search_frontier);
+	printf("\nWeighted A* (w = %.1f)\n", ARA_INITIAL_WEIGHT);
 
-	for (i = 0; i < 4; i++) {
+	a_star(new_maze, S, goals, frontier_type, NULL, ARA_INITIAL_WEIGHT, 0);
 
-		pop(&search_frontier);
+	print_maze(new_maze);
 
-		print_frontier(&search_frontier);
-	}
-}
+	printf("\nAnytime A* (ARA*)\n");
 
-void test_check_frontier(coordinates_t S) {
+	a_star(new_maze, S, goals, frontier_type, NULL, ARA_INITIAL_WEIGHT, ARA_BUDGET_MS);
 
-	node_t *search_frontier = NULL;
-	coordinates_t current_coordinates;
-	int i, priority = 1;
+	print_maze(new_maze);
 
-	search_frontier = new_node(S, priority);
+	printf("\nA* with landmarks (ALT)\n");
 
-	for (i = 0; i < 5; i++) {
+	landmarks = new_landmarks(new_maze, ALT_LANDMARKS);
+	a_star(new_maze, S, goals, frontier_type, landmarks, 1.0, 0);
+	free_landmarks(landmarks);
 
-		S.x++;
-		S.y++;
-		priority++;
+	print_maze(new_maze);
 
-		push(&search_frontier, S, priority);
-	}
+	printf("\nJump Point Search\n");
 
-	print_frontier(&search_frontier);
+	jps(new_maze, S, goals, frontier_type);
 
-	current_coordinates.x = 3;
-	current_coordinates.y = 3;
+	print_maze(new_maze);
 
-	check_frontier(&search_frontier, current_coordinates);
-}
+	printf("\nBidirectional Search\n");
 
-void test_assign_cost(int **maze, int maze_size, coordinates_t S) {
+	bidirectional(new_maze, S, goals, frontier_type);
 
-	int **cell_priority = NULL;
-	int i, j;
+	print_maze(new_maze);
 
-	cell_priority = assign_cost(maze, maze_size, S);
+	printf("\nWavefront BFS\n");
 
-	printf("\n");
+	wavefront(new_maze, S, goals, (int)sysconf(_SC_NPROCESSORS_ONLN));
 
-	for (i = 0; i < maze_size; i++) {
-		for (j = 0; j < maze_size; j++) {
+	print_maze(new_maze);
 
-			printf("%d ", cell_priority[i][j]);
-		}
-		printf("\n");
-	}
+	printf("\nGoal Oracle\n");
 
-	printf("\n");
-}
+	// Built once for these exits, answers any start without searching. Freed before D* Lite changes the maze.
+	oracle = new_oracle(new_maze, goals);
+	goal_oracle(oracle, S);
+	free_oracle(oracle);
 
-void test_heuristic() {
+	print_maze(new_maze);
 
-	coordinates_t current_coordinates, goal_coordinates;
+	if (cpd_file != NULL) {
 
-	current_coordinates.x = 1;
-	current_coordinates.y = 3;
+		printf("\nPath Database\n");
 
-	goal_coordinates.x = 4;
-	goal_coordinates.y = 4;
+		cpd = load_cpd(new_maze, cpd_file);
+		if (cpd == NULL) {
 
-	printf("Heuristic of [%d][%d] with goal node [%d][%d]: %d\n", current_coordinates.x, current_coordinates.y, goal_coordinates.x, goal_coordinates.y, heuristic(current_coordinates, goal_coordinates));
-}
+			cpd = new_cpd(new_maze, (int)sysconf(_SC_NPROCESSORS_ONLN));
+			save_cpd(cpd, cpd_file);
+		}
 
-// -----------------------------------
-// 				Main
-// -----------------------------------
+		path_database(cpd, S, goals);
+		free_cpd(cpd);
 
-int main() {
+		print_maze(new_maze);
+	}
 
-	int **new_maze = NULL;
-	int maze_size;
-	double p;			// Probability of a cell being free. 0 <= p <= 1.
-	coordinates_t S;	// Coordinates of starting cell.
-	coordinates_t G1;	// Coordinates of final (exit) cell 1.
-	coordinates_t G2;	// Coordinates of final (exit) cell 2.
+	printf("\nHierarchical Search (HPA*)\n");
 
-	get_maze_specs(&maze_size, &p);
+	hpa = new_hpa(new_maze, HPA_CLUSTER_SIZE);
+	hpa_star(hpa, S, goals);
 
-	new_maze = create_maze(maze_size);
+	print_maze(new_maze);
 
-	get_coordinates(&S, &G1, &G2, maze_size);
+	printf("\nD* Lite\n");
 
-	set_maze_layout(new_maze, maze_size, p, S, G1, G2);
+	dstar = new_dstar(new_maze, S, goals);
+	d_star_lite(dstar);
 
-	printf("\nUniform Cost Search\n");
+	print_maze(new_maze);
 
-	ucs(new_maze, maze_size, S, G1, G2);
+	// Close the middle cell of the route and let D* Lite repair it, instead of planning from scratch.
+	path_cost = dstar_plan(dstar);
+	if (path_cost > 1) {
 
-	print_maze(new_maze, maze_size);
+		path = dstar_path(dstar, path_cost);
+		printf("\nD* Lite, after closing [%d][%d]\n", path[path_cost / 2].x, path[path_cost / 2].y);
 
-	printf("\nA*\n");
+		dstar_set_cell(dstar, path[path_cost / 2].x, path[path_cost / 2].y, 0);
+		free(path);
 
-	a_star(new_maze, maze_size, S, G1, G2);
+		d_star_lite(dstar);
 
-	print_maze(new_maze, maze_size);
+		print_maze(new_maze);
+	}
 
-	free(new_maze);
+	free_dstar(dstar);
+	free_hpa(hpa);
+	free_goals(goals);
+	free(goal_cells);
+	free_maze(new_maze);
 	return 0;
-}
\ No newline at end of file
+}
+
+#endif